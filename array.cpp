@@ -38,30 +38,175 @@ std::vector<std::wstring> parseArrayW(const std::wstring& input) {
     return result;
 }
 
-std::string arrayToStringA(const std::vector<std::string>& elements) {
-    std::string result = "[";
+template <typename CharT, typename Elements>
+static std::size_t ArrayStringSize(const Elements& elements) {
+    std::size_t size = 2;
 
-    for (std::size_t i = 0; i < elements.size(); ++i) {
-        result += elements[i];
-        if (i != elements.size() - 1) {
-            result += ", ";
+    for (const auto& element : elements) {
+        size += std::basic_string_view<CharT>(element).size();
+    }
+    if (elements.size() > 1) {
+        size += 2 * (elements.size() - 1);
+    }
+
+    return size;
+}
+
+template <typename CharT, typename Elements>
+static CharT* WriteArray(CharT* out, const Elements& elements) {
+    *out++ = CharT('[');
+
+    bool first = true;
+    for (const auto& item : elements) {
+        if (!first) {
+            *out++ = CharT(',');
+            *out++ = CharT(' ');
         }
+        first = false;
+        std::basic_string_view<CharT> element(item);
+        out = std::copy(element.begin(), element.end(), out);
     }
 
-    result += "]";
-    return result;
+    *out++ = CharT(']');
+    return out;
 }
 
-std::wstring arrayToStringW(const std::vector<std::wstring>& elements) {
-    std::wstring result = L"[";
+template <typename CharT, typename Elements>
+static void AppendArray(std::basic_string<CharT>& out, const Elements& elements) {
+    std::size_t offset = out.size();
+    out.resize(offset + ArrayStringSize<CharT>(elements));
+    WriteArray(&out[offset], elements);
+}
+
+template <typename CharT, typename Number>
+static void AppendNumberArray(std::basic_string<CharT>& out, const std::vector<Number>& elements) {
+    // Upper bound of a single std::to_chars result for long and for the shortest form of a double.
+    const std::size_t numberSize = 24;
+
+    std::size_t offset = out.size();
+    out.resize(offset + 2 + elements.size() * (numberSize + 2));
+
+    CharT* cursor = &out[offset];
+    *cursor++ = CharT('[');
 
     for (std::size_t i = 0; i < elements.size(); ++i) {
-        result += elements[i];
-        if (i != elements.size() - 1) {
-            result += L", ";
+        if (i != 0) {
+            *cursor++ = CharT(',');
+            *cursor++ = CharT(' ');
         }
+        char digits[numberSize];
+        auto result = std::to_chars(digits, digits + numberSize, elements[i]);
+        cursor = std::copy(digits, result.ptr, cursor);
     }
 
-    result += L"]";
+    *cursor++ = CharT(']');
+    out.resize(cursor - out.data());
+}
+
+std::string arrayToStringA(const std::vector<std::string>& elements) {
+    std::string result;
+    AppendArray(result, elements);
+    return result;
+}
+
+std::wstring arrayToStringW(const std::vector<std::wstring>& elements) {
+    std::wstring result;
+    AppendArray(result, elements);
+    return result;
+}
+
+std::string arrayToStringA(std::initializer_list<std::string> elements) {
+    std::string result;
+    AppendArray(result, elements);
+    return result;
+}
+
+std::wstring arrayToStringW(std::initializer_list<std::wstring> elements) {
+    std::wstring result;
+    AppendArray(result, elements);
+    return result;
+}
+
+std::string arrayToStringA(const std::vector<std::string_view>& elements) {
+    std::string result;
+    AppendArray(result, elements);
+    return result;
+}
+
+std::wstring arrayToStringW(const std::vector<std::wstring_view>& elements) {
+    std::wstring result;
+    AppendArray(result, elements);
+    return result;
+}
+
+std::string arrayToStringA(const std::vector<long>& elements) {
+    std::string result;
+    AppendNumberArray(result, elements);
+    return result;
+}
+
+std::wstring arrayToStringW(const std::vector<long>& elements) {
+    std::wstring result;
+    AppendNumberArray(result, elements);
     return result;
-}
\ No newline at end of file
+}
+
+std::string arrayToStringA(const std::vector<double>& elements) {
+    std::string result;
+    AppendNumberArray(result, elements);
+    return result;
+}
+
+std::wstring arrayToStringW(const std::vector<double>& elements) {
+    std::wstring result;
+    AppendNumberArray(result, elements);
+    return result;
+}
+
+std::size_t arrayStringSizeA(const std::vector<std::string>& elements) {
+    return ArrayStringSize<char>(elements);
+}
+
+std::size_t arrayStringSizeW(const std::vector<std::wstring>& elements) {
+    return ArrayStringSize<wchar_t>(elements);
+}
+
+std::size_t writeArrayA(char* buffer, std::size_t size, const std::vector<std::string>& elements) {
+    std::size_t required = ArrayStringSize<char>(elements);
+    if (required <= size) {
+        WriteArray(buffer, elements);
+    }
+    return required;
+}
+
+std::size_t writeArrayW(wchar_t* buffer, std::size_t size, const std::vector<std::wstring>& elements) {
+    std::size_t required = ArrayStringSize<wchar_t>(elements);
+    if (required <= size) {
+        WriteArray(buffer, elements);
+    }
+    return required;
+}
+
+void appendArrayA(std::string& out, const std::vector<std::string>& elements) {
+    AppendArray(out, elements);
+}
+
+void appendArrayW(std::wstring& out, const std::vector<std::wstring>& elements) {
+    AppendArray(out, elements);
+}
+
+void appendArrayA(std::string& out, const std::vector<long>& elements) {
+    AppendNumberArray(out, elements);
+}
+
+void appendArrayW(std::wstring& out, const std::vector<long>& elements) {
+    AppendNumberArray(out, elements);
+}
+
+void appendArrayA(std::string& out, const std::vector<double>& elements) {
+    AppendNumberArray(out, elements);
+}
+
+void appendArrayW(std::wstring& out, const std::vector<double>& elements) {
+    AppendNumberArray(out, elements);
+}
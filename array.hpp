@@ -1,6 +1,10 @@
 #pragma once
 
 #include <vector>
+#include <initializer_list>
+#include <string_view>
+#include <algorithm>
+#include <charconv>
 #include <sstream>
 
 #include "defs.h"
@@ -51,6 +55,184 @@ std::string arrayToStringA(const std::vector<std::string>& elements);
  */
 std::wstring arrayToStringW(const std::vector<std::wstring>& elements);
 
+/**
+ * @brief Convert a braced list of strings into a string representation of an array.
+ *
+ * Keeps calls such as arrayToStringA({"a", "b"}) unambiguous next to the view and number overloads.
+ *
+ * @param elements The elements of the array.
+ * @return A string representation of the array.
+ */
+std::string arrayToStringA(std::initializer_list<std::string> elements);
+
+/**
+ * @brief Convert a braced list of Unicode strings into a Unicode string representation of an array.
+ *
+ * Keeps calls such as arrayToStringW({L"a", L"b"}) unambiguous next to the view and number overloads.
+ *
+ * @param elements The elements of the array.
+ * @return A Unicode string representation of the array.
+ */
+std::wstring arrayToStringW(std::initializer_list<std::wstring> elements);
+
+/**
+ * @brief Convert a std::vector<std::string_view> into a string representation of an array.
+ *
+ * This function converts a std::vector<std::string_view> containing elements into a string representation of an array,
+ * where elements are separated by commas and enclosed within square brackets.
+ *
+ * @param elements The std::vector<std::string_view> to convert.
+ * @return A string representation of the array.
+ */
+std::string arrayToStringA(const std::vector<std::string_view>& elements);
+
+/**
+ * @brief Convert a std::vector<std::wstring_view> into a Unicode string representation of an array.
+ *
+ * This function converts a std::vector<std::wstring_view> containing elements into a Unicode string representation of an array,
+ * where elements are separated by commas and enclosed within square brackets.
+ *
+ * @param elements The std::vector<std::wstring_view> to convert.
+ * @return A Unicode string representation of the array.
+ */
+std::wstring arrayToStringW(const std::vector<std::wstring_view>& elements);
+
+/**
+ * @brief Convert a std::vector<long> into a string representation of an array.
+ *
+ * The values are formatted with std::to_chars directly into the result.
+ *
+ * @param elements The std::vector<long> to convert.
+ * @return A string representation of the array.
+ */
+std::string arrayToStringA(const std::vector<long>& elements);
+
+/**
+ * @brief Convert a std::vector<long> into a Unicode string representation of an array.
+ *
+ * The values are formatted with std::to_chars directly into the result.
+ *
+ * @param elements The std::vector<long> to convert.
+ * @return A Unicode string representation of the array.
+ */
+std::wstring arrayToStringW(const std::vector<long>& elements);
+
+/**
+ * @brief Convert a std::vector<double> into a string representation of an array.
+ *
+ * The values are formatted with std::to_chars using the shortest representation that round-trips.
+ *
+ * @param elements The std::vector<double> to convert.
+ * @return A string representation of the array.
+ */
+std::string arrayToStringA(const std::vector<double>& elements);
+
+/**
+ * @brief Convert a std::vector<double> into a Unicode string representation of an array.
+ *
+ * The values are formatted with std::to_chars using the shortest representation that round-trips.
+ *
+ * @param elements The std::vector<double> to convert.
+ * @return A Unicode string representation of the array.
+ */
+std::wstring arrayToStringW(const std::vector<double>& elements);
+
+/**
+ * @brief Compute the exact length of the string representation of an array.
+ *
+ * @param elements The elements of the array.
+ * @return The number of characters arrayToStringA would produce.
+ */
+std::size_t arrayStringSizeA(const std::vector<std::string>& elements);
+
+/**
+ * @brief Compute the exact length of the Unicode string representation of an array.
+ *
+ * @param elements The elements of the array.
+ * @return The number of characters arrayToStringW would produce.
+ */
+std::size_t arrayStringSizeW(const std::vector<std::wstring>& elements);
+
+/**
+ * @brief Write the string representation of an array into a caller-provided buffer.
+ *
+ * The output is not NUL-terminated. Nothing is written if the buffer is too small, so the
+ * return value can be used to size the buffer and call the function again.
+ *
+ * @param buffer The buffer to write to.
+ * @param size The capacity of the buffer, in characters.
+ * @param elements The elements of the array.
+ * @return The length of the representation, whether or not it was written.
+ */
+std::size_t writeArrayA(char* buffer, std::size_t size, const std::vector<std::string>& elements);
+
+/**
+ * @brief Write the Unicode string representation of an array into a caller-provided buffer.
+ *
+ * The output is not NUL-terminated. Nothing is written if the buffer is too small, so the
+ * return value can be used to size the buffer and call the function again.
+ *
+ * @param buffer The buffer to write to.
+ * @param size The capacity of the buffer, in characters.
+ * @param elements The elements of the array.
+ * @return The length of the representation, whether or not it was written.
+ */
+std::size_t writeArrayW(wchar_t* buffer, std::size_t size, const std::vector<std::wstring>& elements);
+
+/**
+ * @brief Append the string representation of an array to a string.
+ *
+ * The string grows once by the exact size of the representation, which is then written in a single pass.
+ * Reusing the same output string across calls avoids allocating at all once it has grown large enough.
+ *
+ * @param out The string to append to.
+ * @param elements The elements of the array.
+ */
+void appendArrayA(std::string& out, const std::vector<std::string>& elements);
+
+/**
+ * @brief Append the Unicode string representation of an array to a string.
+ *
+ * The string grows once by the exact size of the representation, which is then written in a single pass.
+ * Reusing the same output string across calls avoids allocating at all once it has grown large enough.
+ *
+ * @param out The string to append to.
+ * @param elements The elements of the array.
+ */
+void appendArrayW(std::wstring& out, const std::vector<std::wstring>& elements);
+
+/**
+ * @brief Append the string representation of an array of integers to a string.
+ *
+ * @param out The string to append to.
+ * @param elements The elements of the array.
+ */
+void appendArrayA(std::string& out, const std::vector<long>& elements);
+
+/**
+ * @brief Append the Unicode string representation of an array of integers to a string.
+ *
+ * @param out The string to append to.
+ * @param elements The elements of the array.
+ */
+void appendArrayW(std::wstring& out, const std::vector<long>& elements);
+
+/**
+ * @brief Append the string representation of an array of floating-point values to a string.
+ *
+ * @param out The string to append to.
+ * @param elements The elements of the array.
+ */
+void appendArrayA(std::string& out, const std::vector<double>& elements);
+
+/**
+ * @brief Append the Unicode string representation of an array of floating-point values to a string.
+ *
+ * @param out The string to append to.
+ * @param elements The elements of the array.
+ */
+void appendArrayW(std::wstring& out, const std::vector<double>& elements);
+
 #ifdef _UNICODE
 
 /**
@@ -61,6 +243,10 @@ std::wstring arrayToStringW(const std::vector<std::wstring>& elements);
   * @brief Macro defining the function name for converting an array to a Unicode string representation.
   */
 # define IniArrayToStr      arrayToStringW
+ /**
+  * @brief Macro defining the function name for appending an array to a Unicode string.
+  */
+# define IniArrayAppend     appendArrayW
 
 #else
 
@@ -72,5 +258,9 @@ std::wstring arrayToStringW(const std::vector<std::wstring>& elements);
   * @brief Macro defining the function name for converting an array to a string representation.
   */
 # define IniArrayToStr      arrayToStringA
+ /**
+  * @brief Macro defining the function name for appending an array to a string.
+  */
+# define IniArrayAppend     appendArrayA
 
 #endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "async.hpp"
+
+IniLoadPool::IniLoadPool(std::size_t threads)
+    : stopping(false)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+        threads = threads == 0 ? 1 : (threads > 4 ? 4 : threads);
+    }
+
+    this->workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        this->workers.emplace_back([this]() { this->run(); });
+    }
+}
+
+IniLoadPool::~IniLoadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for (auto& worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+IniLoadPool& IniLoadPool::shared()
+{
+    static IniLoadPool pool;
+    return pool;
+}
+
+void IniLoadPool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back(std::move(job));
+    }
+    this->wake.notify_one();
+}
+
+void IniLoadPool::run()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [this]() { return this->stopping || !this->jobs.empty(); });
+            if (this->jobs.empty())
+            {
+                return;
+            }
+            job = std::move(this->jobs.front());
+            this->jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void IniLoadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& body)
+{
+    // Shared with the helper jobs, which may start after this call returned and must then find nothing to do.
+    struct State
+    {
+        std::atomic<std::size_t> next{ 0 };
+        std::size_t count = 0;
+        const std::function<void(std::size_t)>* body = nullptr;
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::size_t running = 0;
+        std::exception_ptr error;
+    };
+
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->body = &body;
+
+    auto work = [](State& shared)
+    {
+        for (std::size_t i = shared.next++; i < shared.count; i = shared.next++)
+        {
+            try
+            {
+                (*shared.body)(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                if (!shared.error)
+                {
+                    shared.error = std::current_exception();
+                }
+                shared.next = shared.count;
+            }
+        }
+    };
+
+    std::size_t helpers = count > 1 ? (this->workers.size() < count - 1 ? this->workers.size() : count - 1) : 0;
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        this->submit([state, work]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->next >= state->count)
+                {
+                    return;
+                }
+                ++state->running;
+            }
+
+            work(*state);
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                --state->running;
+            }
+            state->idle.notify_all();
+        });
+    }
+
+    work(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle.wait(lock, [&state]() { return state->running == 0; });
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
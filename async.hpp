@@ -0,0 +1,254 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <atomic>
+#include                    <cstddef>
+#include                    <deque>
+#include                    <exception>
+#include                    <filesystem>
+#include                    <functional>
+#include                    <future>
+#include                    <memory>
+#include                    <mutex>
+#include                    <condition_variable>
+#include                    <optional>
+#include                    <thread>
+#include                    <type_traits>
+#include                    <utility>
+#include                    <vector>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include                    <coroutine>
+# define XINI_HAS_COROUTINES    1
+#endif
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+/**
+ * @brief Pool of worker threads that load INI files in the background.
+ *
+ * The threads are started by the constructor and joined by the destructor, once the queued jobs are done.
+ * The same threads split the formatting of large documents, see parallel_for().
+ */
+class IniLoadPool {
+public:
+    /**
+     * @brief Start a pool.
+     *
+     * @param threads The number of worker threads. 0 picks the number of hardware threads, up to 4.
+     */
+    explicit IniLoadPool(std::size_t threads = 0);
+
+    ~IniLoadPool();
+
+    IniLoadPool(const IniLoadPool&) = delete;
+    IniLoadPool& operator=(const IniLoadPool&) = delete;
+
+    /**
+     * @brief Get the pool shared by the whole process, started on first use.
+     *
+     * @return The shared pool.
+     */
+    static IniLoadPool& shared();
+
+    /**
+     * @brief Queue a job. It runs on one of the worker threads.
+     *
+     * @param job The job.
+     */
+    void submit(std::function<void()> job);
+
+    /**
+     * @brief Call a function for every index of a range, on the calling thread and on the worker threads.
+     *
+     * The calling thread takes part, so the call also completes when the workers are busy, or when it
+     * is made from a worker thread. Indices are handed out one at a time, so the calls should take
+     * about the same time.
+     *
+     * @param count The number of indices, from 0 to count - 1.
+     * @param body The function called with each index. It is called concurrently.
+     * @throws Any exception thrown by body, the first one, once every running call has returned. The remaining indices are skipped.
+     */
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body);
+
+    /**
+     * @brief Get the number of worker threads.
+     *
+     * @return The number of worker threads.
+     */
+    std::size_t size() const {
+        return this->workers.size();
+    }
+
+private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> workers;
+    bool stopping;
+};
+
+/**
+ * @brief Load INI files without blocking the calling thread.
+ *
+ * The file is opened, read and parsed on a worker thread of an IniLoadPool. load() returns a
+ * std::future, and, when the compiler supports C++20 coroutines, load_async() returns an awaitable
+ * for event-loop services:
+ *
+ *     std::optional<IniParserA> ini = co_await IniAsyncLoaderA::load_async("service.ini", post);
+ *
+ * where post(fn) queues fn on the event loop, so the coroutine resumes on the loop thread.
+ * Without post, the coroutine resumes on the worker thread.
+ */
+template <typename Parser>
+class IniBasicAsyncLoader {
+public:
+    typedef typename Parser::char_type              char_type;
+
+    /**
+     * @brief The parsed file, or std::nullopt if it could not be opened.
+     */
+    typedef std::optional<Parser>                   result_type;
+
+    /**
+     * @brief Function queuing a callback on the thread that should resume the awaiting coroutine.
+     */
+    typedef std::function<void(std::function<void()>)> dispatcher_type;
+
+    /**
+     * @brief Parse an INI file on the calling thread, as the workers do.
+     *
+     * @param filename The name of the INI file.
+     * @param dialect The syntax options.
+     * @return The parsed file, or std::nullopt if it could not be opened.
+     */
+    static result_type load_now(const std::filesystem::path& filename, const IniDialect& dialect = IniDialect()) {
+        Parser ini(dialect);
+        bool opened;
+        if constexpr (std::is_same_v<char_type, char>) {
+            opened = ini >> filename.string().c_str();
+        }
+        else {
+            opened = ini >> filename.wstring().c_str();
+        }
+        if (!opened) {
+            return std::nullopt;
+        }
+        return result_type(std::move(ini));
+    }
+
+    /**
+     * @brief Parse an INI file on a worker thread.
+     *
+     * @param filename The name of the INI file.
+     * @param dialect The syntax options.
+     * @param pool The pool running the parse.
+     * @return A future of the parsed file, or of std::nullopt if it could not be opened.
+     */
+    static std::future<result_type> load(std::filesystem::path filename, IniDialect dialect = IniDialect(), IniLoadPool& pool = IniLoadPool::shared()) {
+        auto task = std::make_shared<std::packaged_task<result_type()>>([filename = std::move(filename), dialect]() {
+            return IniBasicAsyncLoader::load_now(filename, dialect);
+        });
+        std::future<result_type> result = task->get_future();
+        pool.submit([task]() { (*task)(); });
+        return result;
+    }
+
+#if defined(XINI_HAS_COROUTINES)
+
+    /**
+     * @brief Awaitable parse of an INI file, returned by load_async().
+     */
+    class Awaitable {
+    public:
+        Awaitable(std::filesystem::path filename, IniDialect dialect, dispatcher_type dispatch, IniLoadPool& pool)
+            : filename(std::move(filename)), dialect(dialect), dispatch(std::move(dispatch)), pool(&pool) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            this->pool->submit([this, handle]() {
+                try {
+                    this->result = IniBasicAsyncLoader::load_now(this->filename, this->dialect);
+                }
+                catch (...) {
+                    this->error = std::current_exception();
+                }
+
+                // The resumed coroutine may destroy the awaitable, dispatcher included, so it is moved out first.
+                dispatcher_type dispatch = std::move(this->dispatch);
+                if (dispatch) {
+                    dispatch([handle]() { handle.resume(); });
+                }
+                else {
+                    handle.resume();
+                }
+            });
+        }
+
+        result_type await_resume() {
+            if (this->error) {
+                std::rethrow_exception(this->error);
+            }
+            return std::move(this->result);
+        }
+
+    private:
+        std::filesystem::path filename;
+        IniDialect dialect;
+        dispatcher_type dispatch;
+        IniLoadPool* pool;
+        result_type result;
+        std::exception_ptr error;
+    };
+
+    /**
+     * @brief Parse an INI file on a worker thread and resume the awaiting coroutine when it is done.
+     *
+     * @param filename The name of the INI file.
+     * @param dispatch Queues the resumption of the coroutine, for example on an event loop. If empty,
+     *                 the coroutine resumes on the worker thread.
+     * @param dialect The syntax options.
+     * @param pool The pool running the parse.
+     * @return An awaitable resolving to the parsed file, or to std::nullopt if it could not be opened.
+     */
+    static Awaitable load_async(std::filesystem::path filename, dispatcher_type dispatch = dispatcher_type(),
+        IniDialect dialect = IniDialect(), IniLoadPool& pool = IniLoadPool::shared()) {
+        return Awaitable(std::move(filename), dialect, std::move(dispatch), pool);
+    }
+
+#endif
+};
+
+/**
+ * @brief Asynchronous loader of IniParserA.
+ */
+typedef IniBasicAsyncLoader<IniParserA>     IniAsyncLoaderA;
+
+/**
+ * @brief Asynchronous loader of IniParserW.
+ */
+typedef IniBasicAsyncLoader<IniParserW>     IniAsyncLoaderW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the asynchronous loader type based on whether the _UNICODE macro is defined.
+ */
+# define IniAsyncLoader     IniAsyncLoaderW
+
+#else
+
+/**
+ * @brief Macro that defines the asynchronous loader type based on whether the _UNICODE macro is defined.
+ */
+# define IniAsyncLoader     IniAsyncLoaderA
+
+#endif
@@ -0,0 +1,118 @@
+// Replacements of the global allocation functions, so the benchmark suite can count heap allocations.
+//
+// The whole set of replaceable forms is defined, so no allocation bypasses the count and every form is
+// released by its matching deallocation. They live in their own translation unit: once inlined into a
+// caller, a replacement delete calling free() on memory from operator new trips -Wmismatched-new-delete.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+static std::atomic<std::size_t> allocations{ 0 };
+
+std::size_t AllocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+static void* CountedAlloc(std::size_t size) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void* CountedAlloc(std::size_t size, std::align_val_t alignment) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc wants a non-zero size that is a multiple of the alignment.
+    return std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+#endif
+}
+
+static void CountedFree(void* p) noexcept
+{
+    std::free(p);
+}
+
+static void CountedFree(void* p, std::align_val_t) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* p = CountedAlloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* p = CountedAlloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = CountedAlloc(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = CountedAlloc(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size, alignment);
+}
+
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { CountedFree(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { CountedFree(p, alignment); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { CountedFree(p, alignment); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { CountedFree(p, alignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(p, alignment); }
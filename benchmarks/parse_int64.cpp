@@ -0,0 +1,133 @@
+// Compares IniParseInt64 with the stringstream/std::stol implementation it replaced.
+//
+//   g++ -std=c++17 -O2 -I../.. parse_int64.cpp ../decimal.cpp -o parse_int64
+//
+// or as the parse_int64 target of the CMake project of this directory.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "xini/decimal.hpp"
+
+// The previous implementation, kept verbatim as the baseline.
+namespace legacy {
+
+    static long ParseDecimalBasedString(const IniString& str, int base)
+    {
+        return std::stol(str, nullptr, base);
+    }
+
+    static long ParseHexString(const IniString& hexStr)
+    {
+        size_t pos = 0x000;
+        if (hexStr.find(IniT("0x")) == 0x000)
+        {
+            pos = 0x002;
+        }
+        return ParseDecimalBasedString(hexStr.substr(pos), 0x10);
+    }
+
+    static long ParseBinaryString(const IniString& binStr)
+    {
+        size_t pos = 0b0;
+        if (binStr.find(IniT("0b")) == 0b0)
+        {
+            pos = 0b10;
+        }
+
+        return ParseDecimalBasedString(binStr.substr(pos), 0b10);
+    }
+
+    static bool IsHexString(const IniString& str)
+    {
+        return str.find(IniT("0x")) == 0;
+    }
+
+    static bool IsBinaryString(const IniString& str)
+    {
+        return str.find(IniT("0b")) == 0;
+    }
+
+    static bool IsDecimalString(const IniString& str)
+    {
+        try
+        {
+            ParseDecimalBasedString(str, 0xA);
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    static long IniParseInt64(const IniString& str)
+    {
+        if (!IsDecimalString(str))
+        {
+            throw std::runtime_error("Value cannot be a decimal type");
+        }
+
+        if (IsBinaryString(str))
+        {
+            return ParseBinaryString(str);
+        }
+
+        else if (IsHexString(str))
+        {
+            return ParseHexString(str);
+        }
+
+        return ParseDecimalBasedString(str, 0xA);
+    }
+
+}
+
+template <typename Fn>
+static double Measure(const std::vector<IniString>& corpus, int rounds, Fn parse)
+{
+    volatile long sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto& value : corpus) {
+            sink = sink + parse(value);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(rounds) * corpus.size());
+}
+
+int main(int argc, char** argv) {
+
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    std::vector<IniString> decimal, hex, binary;
+    for (long i = 0; i < 10000; ++i) {
+        long value = i * 7919 % 1000003;
+        std::string digits = std::to_string(value);
+        decimal.push_back(IniString(digits.begin(), digits.end()));
+        hex.push_back(Int64ToHexString(value));
+        binary.push_back(Int64ToBinaryString(value));
+    }
+
+    struct Case { const char* name; const std::vector<IniString>* corpus; };
+    const Case cases[] = { { "decimal", &decimal }, { "hex", &hex }, { "binary", &binary } };
+
+    for (const auto& c : cases) {
+        double before = Measure(*c.corpus, rounds, legacy::IniParseInt64);
+        double after = Measure(*c.corpus, rounds, IniParseInt64);
+        double view = Measure(*c.corpus, rounds, [](const IniString& str) {
+            long value = 0;
+            IniTryParseInt64(str, value);
+            return value;
+        });
+
+        std::cout << c.name << ": legacy " << before << " ns/op, IniParseInt64 " << after
+                  << " ns/op, IniTryParseInt64 " << view << " ns/op (" << before / view << "x)" << std::endl;
+    }
+
+    return 0;
+}
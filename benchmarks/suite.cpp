@@ -0,0 +1,406 @@
+// Benchmark suite for parsing, lookups, conversions and commits.
+//
+// Every benchmark reports the time per operation, its throughput, the number of heap allocations
+// per operation and, at the end, the peak resident set size of the process. The INI corpus is
+// generated from the command line options:
+//
+//   xini_bench [--sections N] [--keys N] [--value-length N] [--unicode] [--min-time MS] [--filter TEXT]
+//
+// --unicode puts non-ASCII characters in the values and runs the IniParserW benchmarks as well.
+//
+// Built by the CMake project of this directory:
+//
+//   cmake -S benchmarks -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build && ./build/xini_bench
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <locale>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "xini/parser.hpp"
+#include "xini/utils.hpp"
+#include "xini/array.hpp"
+#include "xini/dict.hpp"
+#include "xini/decimal.hpp"
+#include "xini/frozen.hpp"
+#include "xini/writer.hpp"
+
+// Number of heap allocations made by the process so far, counted by the operators of allocations.cpp.
+std::size_t AllocationCount();
+
+static std::size_t PeakResidentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Keeps the optimizer from discarding a result.
+template <typename T>
+static void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+struct Options {
+    std::size_t sections = 100;
+    std::size_t keys = 20;
+    std::size_t valueLength = 16;
+    bool unicode = false;
+    double minTimeMs = 200;
+    std::string filter;
+};
+
+// What one call of a benchmark body processes, to turn the time into a throughput.
+struct Work {
+    std::size_t bytes = 0;
+    std::size_t items = 0;
+};
+
+struct Benchmark {
+    std::string name;
+    Work work;
+    std::function<void(std::size_t)> body;
+};
+
+struct Corpus {
+    std::string ascii;
+    std::wstring wide;
+    std::vector<std::pair<std::string, std::string>> keys;
+    std::vector<std::pair<std::wstring, std::wstring>> wideKeys;
+};
+
+static Corpus GenerateCorpus(const Options& options)
+{
+    // "é" and "世" in UTF-8, widened to a single character each in the wide corpus.
+    static const char* const unicodeA[] = { "\xC3\xA9", "\xE4\xB8\x96" };
+    static const wchar_t unicodeW[] = { L'\u00E9', L'\u4E16' };
+
+    Corpus corpus;
+    std::uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    for (std::size_t s = 0; s < options.sections; ++s) {
+        std::string section = "section" + std::to_string(s);
+        corpus.ascii += "[" + section + "]\n";
+        corpus.wide += L"[" + std::wstring(section.begin(), section.end()) + L"]\n";
+
+        for (std::size_t k = 0; k < options.keys; ++k) {
+            std::string key = "key" + std::to_string(k);
+            std::string value;
+            std::wstring wideValue;
+            for (std::size_t i = 0; i < options.valueLength; ++i) {
+                if (options.unicode && i % 4 == 3) {
+                    std::size_t pick = next() % 2;
+                    value += unicodeA[pick];
+                    wideValue += unicodeW[pick];
+                }
+                else {
+                    char c = static_cast<char>('a' + next() % 26);
+                    value += c;
+                    wideValue += static_cast<wchar_t>(c);
+                }
+            }
+
+            corpus.ascii += key + "=" + value + "\n";
+            corpus.wide += std::wstring(key.begin(), key.end()) + L"=" + wideValue + L"\n";
+            corpus.keys.emplace_back(section, key);
+            corpus.wideKeys.emplace_back(std::wstring(section.begin(), section.end()), std::wstring(key.begin(), key.end()));
+        }
+    }
+
+    return corpus;
+}
+
+static void Run(const Benchmark& benchmark, const Options& options)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Double the iteration count until a run lasts long enough, then report that run.
+    std::size_t iterations = 1;
+    for (;;) {
+        std::size_t allocationsBefore = AllocationCount();
+        auto start = clock::now();
+        benchmark.body(iterations);
+        double elapsedNs = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        std::size_t allocated = AllocationCount() - allocationsBefore;
+
+        if (elapsedNs >= options.minTimeMs * 1e6 || iterations >= (std::size_t(1) << 30)) {
+            double nsPerOp = elapsedNs / iterations;
+            std::printf("%-28s %12zu %14.1f ns/op", benchmark.name.c_str(), iterations, nsPerOp);
+            if (benchmark.work.bytes) {
+                std::printf(" %10.1f MB/s", benchmark.work.bytes / nsPerOp * 1e3);
+            }
+            if (benchmark.work.items) {
+                std::printf(" %10.2f M items/s", benchmark.work.items / nsPerOp * 1e3);
+            }
+            std::printf(" %12.1f allocs/op\n", static_cast<double>(allocated) / iterations);
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+static Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--sections") {
+            options.sections = std::strtoul(value(), nullptr, 10);
+        }
+        else if (arg == "--keys") {
+            options.keys = std::strtoul(value(), nullptr, 10);
+        }
+        else if (arg == "--value-length") {
+            options.valueLength = std::strtoul(value(), nullptr, 10);
+        }
+        else if (arg == "--min-time") {
+            options.minTimeMs = std::strtod(value(), nullptr);
+        }
+        else if (arg == "--filter") {
+            options.filter = value();
+        }
+        else if (arg == "--unicode") {
+            options.unicode = true;
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+
+    const Options options = ParseOptions(argc, argv);
+    const Corpus corpus = GenerateCorpus(options);
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string inputPath = (directory / "xini_bench_input.ini").string();
+    const std::string outputPath = (directory / "xini_bench_output.ini").string();
+    {
+        std::ofstream file(inputPath, std::ios::binary);
+        file << corpus.ascii;
+    }
+
+    IniParserA loaded;
+    loaded << corpus.ascii.c_str();
+
+    const IniFrozenA frozen(loaded);
+
+    IniParserA other;
+    for (std::size_t i = 0; i < corpus.keys.size(); i += 2) {
+        other.set(corpus.keys[i].first.c_str(), corpus.keys[i].second.c_str(), std::string("override"));
+    }
+
+    std::vector<std::string> integers;
+    for (long i = 0; i < 1000; ++i) {
+        long value = i * 7919 % 1000003;
+        integers.push_back(i % 3 == 0 ? std::to_string(value) : i % 3 == 1 ? Int64ToHexString(value) : Int64ToBinaryString(value));
+    }
+
+    std::string array = "[";
+    std::string dictionary = "{";
+    for (std::size_t i = 0; i < options.keys; ++i) {
+        const std::string& value = loaded.view().begin()->second.at("key" + std::to_string(i));
+        array += (i ? ", " : "") + value;
+        dictionary += (i ? ", key" : "key") + std::to_string(i) + ": " + value;
+    }
+    array += "]";
+    dictionary += "}";
+
+    const std::size_t pairs = corpus.keys.size();
+    std::vector<Benchmark> benchmarks = {
+        { "parse/string", { corpus.ascii.size(), pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                IniParserA ini;
+                ini << corpus.ascii.c_str();
+                DoNotOptimize(ini);
+            }
+        } },
+        { "parse/file", { corpus.ascii.size(), pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                IniParserA ini;
+                ini >> inputPath.c_str();
+                DoNotOptimize(ini);
+            }
+        } },
+        { "parse/feed (4 KiB chunks)", { corpus.ascii.size(), pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                IniParserA ini;
+                for (std::size_t offset = 0; offset < corpus.ascii.size(); offset += 4096) {
+                    ini.feed(corpus.ascii.data() + offset, std::min<std::size_t>(4096, corpus.ascii.size() - offset));
+                }
+                ini.finish();
+                DoNotOptimize(ini);
+            }
+        } },
+        { "get", { 0, 1 }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& key = corpus.keys[i % pairs];
+                DoNotOptimize(loaded.get(key.first.c_str(), key.second.c_str()));
+            }
+        } },
+        { "get (frozen)", { 0, 1 }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& key = corpus.keys[i % pairs];
+                DoNotOptimize(frozen.lookup(key.first, key.second));
+            }
+        } },
+        { "set", { 0, 1 }, [&](std::size_t n) {
+            IniParserA ini = loaded;
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& key = corpus.keys[i % pairs];
+                ini.set(key.first.c_str(), key.second.c_str(), static_cast<long>(i));
+            }
+            DoNotOptimize(ini);
+        } },
+        { "commit", { corpus.ascii.size(), pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                loaded.commit(outputPath.c_str());
+            }
+        } },
+        { "commit (parallel)", { corpus.ascii.size(), pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                IniParallelWriterA::commit(loaded, outputPath);
+            }
+        } },
+        { "IniParseInt64", { 0, 1 }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                DoNotOptimize(IniParseInt64(integers[i % integers.size()]));
+            }
+        } },
+        { "parseArrayA", { array.size(), options.keys }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                DoNotOptimize(parseArrayA(array));
+            }
+        } },
+        { "parseDictionaryA", { dictionary.size(), options.keys }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                DoNotOptimize(parseDictionaryA(dictionary));
+            }
+        } },
+        { "MergeIniParsersA", { 0, pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                DoNotOptimize(MergeIniParsersA(loaded, other));
+            }
+        } },
+        { "ToIniParserW", { corpus.ascii.size(), pairs }, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                DoNotOptimize(ToIniParserW(loaded));
+            }
+        } },
+    };
+
+    IniParserW loadedW;
+    if (options.unicode) {
+        // Wide file streams convert with the global locale, which must handle the non-ASCII values.
+        try {
+            std::locale::global(std::locale("C.UTF-8"));
+        }
+        catch (const std::runtime_error&) {
+            try {
+                std::locale::global(std::locale(""));
+            }
+            catch (const std::runtime_error&) {
+            }
+        }
+
+        loadedW << corpus.wide.c_str();
+
+        std::vector<Benchmark> wide = {
+            { "parse/string (wide)", { corpus.wide.size() * sizeof(wchar_t), pairs }, [&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    IniParserW ini;
+                    ini << corpus.wide.c_str();
+                    DoNotOptimize(ini);
+                }
+            } },
+            { "get (wide)", { 0, 1 }, [&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const auto& key = corpus.wideKeys[i % pairs];
+                    DoNotOptimize(loadedW.get<std::wstring>(key.first.c_str(), key.second.c_str()));
+                }
+            } },
+            { "set (wide)", { 0, 1 }, [&](std::size_t n) {
+                IniParserW ini = loadedW;
+                for (std::size_t i = 0; i < n; ++i) {
+                    const auto& key = corpus.wideKeys[i % pairs];
+                    ini.set(key.first.c_str(), key.second.c_str(), static_cast<long>(i));
+                }
+                DoNotOptimize(ini);
+            } },
+            { "commit (wide)", { corpus.wide.size() * sizeof(wchar_t), pairs }, [&](std::size_t n) {
+                const std::wstring path = (directory / "xini_bench_output_w.ini").wstring();
+                for (std::size_t i = 0; i < n; ++i) {
+                    loadedW.commit(path.c_str());
+                }
+            } },
+            { "commit (wide, parallel)", { corpus.wide.size() * sizeof(wchar_t), pairs }, [&](std::size_t n) {
+                const std::filesystem::path path = directory / "xini_bench_output_w.ini";
+                for (std::size_t i = 0; i < n; ++i) {
+                    IniParallelWriterW::commit(loadedW, path);
+                }
+            } },
+        };
+        benchmarks.insert(benchmarks.end(), wide.begin(), wide.end());
+    }
+
+    std::printf("corpus: %zu sections x %zu keys, %zu-character values, %s, %zu bytes\n\n",
+        options.sections, options.keys, options.valueLength, options.unicode ? "unicode" : "ascii", corpus.ascii.size());
+    std::printf("%-28s %12s %20s\n", "benchmark", "iterations", "time");
+
+    for (const auto& benchmark : benchmarks) {
+        if (benchmark.name.find(options.filter) != std::string::npos) {
+            Run(benchmark, options);
+        }
+    }
+
+    std::printf("\npeak RSS: %.1f MB\n", PeakResidentBytes() / (1024.0 * 1024.0));
+
+    std::filesystem::remove(inputPath);
+    std::filesystem::remove(outputPath);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "bulk.hpp"
+
+static IniParseStatus DecodeValue(std::basic_string_view<IniChar> str, long& value)
+{
+    return IniParseInt64Chars(str.data(), str.data() + str.size(), value);
+}
+
+static IniParseStatus DecodeValue(std::basic_string_view<IniChar> str, double& value)
+{
+    return IniParseDoubleChars(str.data(), str.data() + str.size(), value);
+}
+
+template <typename Number>
+static std::size_t DecodeSection(const IniParser& ini, std::basic_string_view<IniChar> section, std::vector<Number>& values, std::vector<std::size_t>* failures)
+{
+    auto sectionIt = ini.view().find(section);
+    if (sectionIt == ini.view().end())
+    {
+        return 0;
+    }
+
+    const auto& pairs = sectionIt->second;
+    std::size_t offset = values.size();
+    std::size_t failed = 0;
+
+    values.resize(offset + pairs.size());
+    Number* out = values.data() + offset;
+
+    std::size_t index = 0;
+    for (const auto& pair : pairs)
+    {
+        if (DecodeValue(pair.second, out[index]) != IniParseOk)
+        {
+            out[index] = 0;
+            ++failed;
+            if (failures)
+            {
+                failures->push_back(index);
+            }
+        }
+        ++index;
+    }
+
+    return failed;
+}
+
+template <typename Number>
+static std::size_t DecodeArray(std::basic_string_view<IniChar> array, std::vector<Number>& values, std::vector<std::size_t>* failures)
+{
+    std::size_t first = array.find_first_not_of(IniT(" \t\r\n"));
+    std::size_t last = array.find_last_not_of(IniT(" \t\r\n"));
+    if (first == std::basic_string_view<IniChar>::npos)
+    {
+        return 0;
+    }
+
+    array = array.substr(first, last - first + 1);
+    if (!array.empty() && array.front() == IniT('['))
+    {
+        array.remove_prefix(1);
+    }
+    if (!array.empty() && array.back() == IniT(']'))
+    {
+        array.remove_suffix(1);
+    }
+    if (array.find_first_not_of(IniT(" \t\r\n")) == std::basic_string_view<IniChar>::npos)
+    {
+        return 0;
+    }
+
+    std::size_t failed = 0;
+    std::size_t index = 0;
+
+    while (true)
+    {
+        std::size_t comma = array.find(IniT(','));
+        Number value = 0;
+
+        if (DecodeValue(array.substr(0, comma), value) != IniParseOk)
+        {
+            value = 0;
+            ++failed;
+            if (failures)
+            {
+                failures->push_back(index);
+            }
+        }
+        values.push_back(value);
+        ++index;
+
+        if (comma == std::basic_string_view<IniChar>::npos)
+        {
+            break;
+        }
+        array.remove_prefix(comma + 1);
+    }
+
+    return failed;
+}
+
+std::size_t IniDecodeInt64Section(const IniParser& ini, std::basic_string_view<IniChar> section, std::vector<long>& values, std::vector<std::size_t>* failures)
+{
+    return DecodeSection(ini, section, values, failures);
+}
+
+std::size_t IniDecodeDoubleSection(const IniParser& ini, std::basic_string_view<IniChar> section, std::vector<double>& values, std::vector<std::size_t>* failures)
+{
+    return DecodeSection(ini, section, values, failures);
+}
+
+std::size_t IniDecodeInt64Array(std::basic_string_view<IniChar> array, std::vector<long>& values, std::vector<std::size_t>* failures)
+{
+    return DecodeArray(array, values, failures);
+}
+
+std::size_t IniDecodeDoubleArray(std::basic_string_view<IniChar> array, std::vector<double>& values, std::vector<std::size_t>* failures)
+{
+    return DecodeArray(array, values, failures);
+}
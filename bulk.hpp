@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+
+#include "parser.hpp"
+#include "decimal.hpp"
+
+/**
+ * @brief Decode every value of a section as a long integer.
+ *
+ * This function walks the section in place, without copying any key or value, and parses each value
+ * with IniParseInt64Chars. The results are appended to values in key order (the order of view()),
+ * one element per key. Values that cannot be parsed are stored as 0 and their position in the section
+ * is appended to failures.
+ *
+ * @param ini The parser to read from.
+ * @param section The section to decode.
+ * @param values The vector the decoded values are appended to.
+ * @param failures Optional vector receiving the positions of the values that could not be parsed.
+ * @return The number of values that could not be parsed. A missing section decodes to nothing and returns 0.
+ */
+std::size_t IniDecodeInt64Section(const IniParser& ini, std::basic_string_view<IniChar> section, std::vector<long>& values, std::vector<std::size_t>* failures = nullptr);
+
+/**
+ * @brief Decode every value of a section as a floating-point number.
+ *
+ * This function follows the same rules as IniDecodeInt64Section, parsing each value with IniParseDoubleChars.
+ *
+ * @param ini The parser to read from.
+ * @param section The section to decode.
+ * @param values The vector the decoded values are appended to.
+ * @param failures Optional vector receiving the positions of the values that could not be parsed.
+ * @return The number of values that could not be parsed.
+ */
+std::size_t IniDecodeDoubleSection(const IniParser& ini, std::basic_string_view<IniChar> section, std::vector<double>& values, std::vector<std::size_t>* failures = nullptr);
+
+/**
+ * @brief Decode every element of an array value as a long integer.
+ *
+ * The array "[1, 0x2, 0b11]" is scanned in place, without splitting it into strings first. The results
+ * are appended to values, one element per array element. Elements that cannot be parsed are stored
+ * as 0 and their index is appended to failures.
+ *
+ * @param array The string representing the array.
+ * @param values The vector the decoded values are appended to.
+ * @param failures Optional vector receiving the indices of the elements that could not be parsed.
+ * @return The number of elements that could not be parsed.
+ */
+std::size_t IniDecodeInt64Array(std::basic_string_view<IniChar> array, std::vector<long>& values, std::vector<std::size_t>* failures = nullptr);
+
+/**
+ * @brief Decode every element of an array value as a floating-point number.
+ *
+ * This function follows the same rules as IniDecodeInt64Array, parsing each element with IniParseDoubleChars.
+ *
+ * @param array The string representing the array.
+ * @param values The vector the decoded values are appended to.
+ * @param failures Optional vector receiving the indices of the elements that could not be parsed.
+ * @return The number of elements that could not be parsed.
+ */
+std::size_t IniDecodeDoubleArray(std::basic_string_view<IniChar> array, std::vector<double>& values, std::vector<std::size_t>* failures = nullptr);
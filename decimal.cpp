@@ -1,96 +1,420 @@
 #include "decimal.hpp"
 
-static long ParseDecimalBasedString(const IniString& str, int base)
+// Value of every ASCII character as a digit, or 0xFF if it is not a digit of any supported radix.
+static const unsigned char DigitValues[0x80] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+template <typename CharT>
+static bool IsNumberSpace(CharT c)
 {
-    return std::stol(str, nullptr, base);
+    return c == CharT(' ') || c == CharT('\t') || c == CharT('\r') || c == CharT('\n');
 }
 
-static long ParseHexString(const IniString& hexStr)
+template <typename CharT>
+static unsigned DigitValue(CharT c)
 {
-    size_t pos = 0x000;
-    if (hexStr.find(IniT("0x")) == 0x000)
+    return static_cast<unsigned long>(c) < 0x80 ? DigitValues[static_cast<unsigned long>(c)] : 0xFF;
+}
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+# define IniSwarDigits      1
+#endif
+
+/**
+ * Decodes eight ASCII decimal digits at once with 64-bit SWAR arithmetic.
+ * Returns false, without touching value, if any of the eight characters is not a digit.
+ */
+static bool ParseEightDigits(const char* chars, unsigned long long& value)
+{
+#ifdef IniSwarDigits
+    unsigned long long chunk;
+    std::memcpy(&chunk, chars, sizeof(chunk));
+
+    // Every byte must be in '0'..'9': high nibble 3, and still high nibble 3 after adding 6.
+    if ((chunk & 0xF0F0F0F0F0F0F0F0ull) != 0x3030303030303030ull ||
+        ((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) != 0x3030303030303030ull)
     {
-        pos = 0x002;
+        return false;
     }
-    return ParseDecimalBasedString(hexStr.substr(pos), 0x10);
+
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    value = ((chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+    return true;
+#else
+    (void)chars;
+    (void)value;
+    return false;
+#endif
 }
 
-static long ParseBinaryString(const IniString& binStr)
+/**
+ * Scans an optionally signed, optionally prefixed integer into its magnitude.
+ * The limits bound the magnitude of negative, unprefixed and prefixed numbers respectively.
+ */
+template <typename CharT>
+static IniParseStatus ParseMagnitude(const CharT* first, const CharT* last,
+    unsigned long long negativeMax, unsigned long long decimalMax, unsigned long long prefixedMax,
+    bool& negative, unsigned long long& magnitude)
 {
-    size_t pos = 0b0;
-    if (binStr.find(IniT("0b")) == 0b0)
+    while (first != last && IsNumberSpace(*first))
     {
-        pos = 0b10;
+        ++first;
     }
+    while (last != first && IsNumberSpace(last[-1]))
+    {
+        --last;
+    }
+    if (first == last)
+    {
+        return IniParseEmpty;
+    }
+
+    negative = false;
+    if (*first == CharT('-') || *first == CharT('+'))
+    {
+        negative = *first == CharT('-');
+        ++first;
+    }
+
+    unsigned base = 0xA;
+    if (last - first > 0b10 && *first == CharT('0'))
+    {
+        switch (first[1])
+        {
+        case CharT('x'): case CharT('X'): base = 0x10; first += 2; break;
+        case CharT('b'): case CharT('B'): base = 0b10; first += 2; break;
+        case CharT('o'): case CharT('O'): base = 010;  first += 2; break;
+        default: break;
+        }
+    }
+    if (first == last)
+    {
+        return IniParseInvalid;
+    }
+
+    const unsigned long long maxMagnitude = negative ? negativeMax : base == 0xA ? decimalMax : prefixedMax;
+    const unsigned long long cutoff = maxMagnitude / base;
+    const unsigned cutlim = static_cast<unsigned>(maxMagnitude % base);
+
+    magnitude = 0;
+    bool afterDigit = false;
+
+    for (; first != last; ++first)
+    {
+        if constexpr (sizeof(CharT) == 1)
+        {
+            unsigned long long chunk;
+            if (base == 0xA && last - first >= 8 && ParseEightDigits(reinterpret_cast<const char*>(first), chunk))
+            {
+                if (chunk > maxMagnitude || magnitude > (maxMagnitude - chunk) / 100000000ull)
+                {
+                    return IniParseOverflow;
+                }
+                magnitude = magnitude * 100000000ull + chunk;
+                afterDigit = true;
+                first += 7;
+                continue;
+            }
+        }
 
-    return ParseDecimalBasedString(binStr.substr(pos), 0b10);
+        unsigned digit = DigitValue(*first);
+        if (digit >= base)
+        {
+            // An underscore may only separate two digits.
+            if (*first == CharT('_') && afterDigit && first + 1 != last && DigitValue(first[1]) < base)
+            {
+                afterDigit = false;
+                continue;
+            }
+            return IniParseInvalid;
+        }
+        if (magnitude > cutoff || (magnitude == cutoff && digit > cutlim))
+        {
+            return IniParseOverflow;
+        }
+        magnitude = magnitude * base + digit;
+        afterDigit = true;
+    }
+
+    return IniParseOk;
 }
 
-static bool IsHexString(const IniString& str)
+template <typename CharT>
+IniParseStatus IniParseInt64Chars(const CharT* first, const CharT* last, long& value)
 {
-    return str.find(IniT("0x")) == 0;
+    // Prefixed numbers may use the whole unsigned range (two's complement), decimal ones only the signed range.
+    bool negative;
+    unsigned long long magnitude;
+    IniParseStatus status = ParseMagnitude(first, last,
+        static_cast<unsigned long>(-(LONG_MIN + 1)) + 1ull, static_cast<unsigned long long>(LONG_MAX), ULONG_MAX,
+        negative, magnitude);
+    if (status != IniParseOk)
+    {
+        return status;
+    }
+
+    unsigned long bits = static_cast<unsigned long>(magnitude);
+    value = static_cast<long>(negative ? 0 - bits : bits);
+    return IniParseOk;
 }
 
-static bool IsBinaryString(const IniString& str)
+template <typename CharT>
+IniParseStatus IniParseUInt64Chars(const CharT* first, const CharT* last, unsigned long long& value)
 {
-    return str.find(IniT("0b")) == 0;
+    // Only zero may carry a minus sign.
+    bool negative;
+    unsigned long long magnitude;
+    IniParseStatus status = ParseMagnitude(first, last, 0, ULLONG_MAX, ULLONG_MAX, negative, magnitude);
+    if (status != IniParseOk)
+    {
+        return status;
+    }
+
+    value = magnitude;
+    return IniParseOk;
 }
 
-static bool IsDecimalString(const IniString& str)
+template IniParseStatus IniParseInt64Chars<char>(const char* first, const char* last, long& value);
+template IniParseStatus IniParseInt64Chars<wchar_t>(const wchar_t* first, const wchar_t* last, long& value);
+template IniParseStatus IniParseUInt64Chars<char>(const char* first, const char* last, unsigned long long& value);
+template IniParseStatus IniParseUInt64Chars<wchar_t>(const wchar_t* first, const wchar_t* last, unsigned long long& value);
+
+template <typename CharT>
+IniParseStatus IniParseDoubleChars(const CharT* first, const CharT* last, double& value)
 {
-    try
+    while (first != last && IsNumberSpace(*first))
     {
-        ParseDecimalBasedString(str, 0xA);
-        return true;
+        ++first;
     }
-    catch (...)
+    while (last != first && IsNumberSpace(last[-1]))
     {
-        return false;
+        --last;
+    }
+    if (first == last)
+    {
+        return IniParseEmpty;
+    }
+
+    // std::from_chars does not accept a leading '+'.
+    if (*first == CharT('+') && last - first > 1 && first[1] != CharT('-'))
+    {
+        ++first;
+    }
+
+    const char* narrow;
+    char buffer[0x80];
+    std::size_t length = static_cast<std::size_t>(last - first);
+
+    if constexpr (sizeof(CharT) == 1)
+    {
+        narrow = reinterpret_cast<const char*>(first);
+    }
+    else
+    {
+        if (length > sizeof(buffer))
+        {
+            return IniParseInvalid;
+        }
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if (static_cast<unsigned long>(first[i]) >= 0x80)
+            {
+                return IniParseInvalid;
+            }
+            buffer[i] = static_cast<char>(first[i]);
+        }
+        narrow = buffer;
+    }
+
+    double parsed = 0;
+    auto result = std::from_chars(narrow, narrow + length, parsed);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        return IniParseOverflow;
+    }
+    if (result.ec != std::errc() || result.ptr != narrow + length)
+    {
+        return IniParseInvalid;
     }
+
+    value = parsed;
+    return IniParseOk;
 }
 
+template IniParseStatus IniParseDoubleChars<char>(const char* first, const char* last, double& value);
+template IniParseStatus IniParseDoubleChars<wchar_t>(const wchar_t* first, const wchar_t* last, double& value);
+
 long IniParseInt64(const IniString& str)
 {
-    if (!IsDecimalString(str))
+    long value = 0;
+
+    switch (IniTryParseInt64(str, value))
     {
+    case IniParseOk:
+        return value;
+    case IniParseOverflow:
+        throw std::out_of_range("Value is out of range");
+    default:
         throw std::runtime_error("Value cannot be a decimal type");
     }
+}
 
-    if (IsBinaryString(str))
+static const char HexDigits[] = "0123456789ABCDEF";
+
+static const char BinaryNibbles[16][4] = {
+    { '0', '0', '0', '0' }, { '0', '0', '0', '1' }, { '0', '0', '1', '0' }, { '0', '0', '1', '1' },
+    { '0', '1', '0', '0' }, { '0', '1', '0', '1' }, { '0', '1', '1', '0' }, { '0', '1', '1', '1' },
+    { '1', '0', '0', '0' }, { '1', '0', '0', '1' }, { '1', '0', '1', '0' }, { '1', '0', '1', '1' },
+    { '1', '1', '0', '0' }, { '1', '1', '0', '1' }, { '1', '1', '1', '0' }, { '1', '1', '1', '1' },
+};
+
+static std::size_t CountDigits(unsigned long value, unsigned bitsPerDigit, std::size_t minWidth)
+{
+    std::size_t digits = 1;
+    while (digits * bitsPerDigit < sizeof(unsigned long) * 0b1000 && (value >> (digits * bitsPerDigit)) != 0)
     {
-        return ParseBinaryString(str);
+        ++digits;
     }
+    return digits < minWidth ? minWidth : digits;
+}
+
+static std::size_t BinaryCharsSize(long value, std::size_t minWidth)
+{
+    return 0b10 + CountDigits(static_cast<unsigned long>(value), 0b1, minWidth);
+}
+
+static std::size_t HexCharsSize(long value, std::size_t minWidth)
+{
+    return 0x2 + CountDigits(static_cast<unsigned long>(value), 0x4, minWidth);
+}
 
-    else if (IsHexString(str))
+static void WriteBinaryChars(IniChar* buffer, std::size_t length, long value)
+{
+    unsigned long bits = static_cast<unsigned long>(value);
+    IniChar* cursor = buffer + length;
+    std::size_t remaining = length - 0b10;
+
+    // Digits are written from the least significant end, one nibble per table lookup.
+    while (remaining >= 0b100)
+    {
+        const char* nibble = BinaryNibbles[bits & 0xF];
+        cursor -= 0b100;
+        cursor[0] = nibble[0];
+        cursor[1] = nibble[1];
+        cursor[2] = nibble[2];
+        cursor[3] = nibble[3];
+        bits = bits >> 0b100;
+        remaining -= 0b100;
+    }
+    while (remaining)
     {
-        return ParseHexString(str);
+        *--cursor = static_cast<IniChar>('0' + (bits & 0b1));
+        bits = bits >> 0b1;
+        --remaining;
     }
 
-    return ParseDecimalBasedString(str, 0xA);
+    buffer[0] = IniT('0');
+    buffer[1] = IniT('b');
 }
 
-IniString Int64ToBinaryString(long value)
+static void WriteHexChars(IniChar* buffer, std::size_t length, long value)
 {
-#ifdef _UNICODE
-    std::wostringstream oss;
-#else
-    std::ostringstream oss;
-#endif
+    unsigned long bits = static_cast<unsigned long>(value);
+    IniChar* cursor = buffer + length;
+    std::size_t remaining = length - 0x2;
 
-    oss << IniT("0b") << std::bitset<sizeof(long) * 0b1000>(value);
+    while (remaining)
+    {
+        *--cursor = static_cast<IniChar>(HexDigits[bits & 0xF]);
+        bits = bits >> 0x4;
+        --remaining;
+    }
 
-    return oss.str();
+    buffer[0] = IniT('0');
+    buffer[1] = IniT('x');
 }
 
-IniString Int64ToHexString(long value)
+std::size_t Int64ToBinaryChars(IniChar* buffer, std::size_t size, long value, std::size_t minWidth)
 {
-#ifdef _UNICODE
-    std::wostringstream oss;
-#else
-    std::ostringstream oss;
-#endif
+    std::size_t length = BinaryCharsSize(value, minWidth);
+    if (length <= size)
+    {
+        WriteBinaryChars(buffer, length, value);
+    }
+    return length;
+}
 
-    oss << IniT("0x") << std::hex << std::uppercase << value;
+std::size_t Int64ToHexChars(IniChar* buffer, std::size_t size, long value, std::size_t minWidth)
+{
+    std::size_t length = HexCharsSize(value, minWidth);
+    if (length <= size)
+    {
+        WriteHexChars(buffer, length, value);
+    }
+    return length;
+}
+
+IniString Int64ToBinaryString(long value, std::size_t minWidth)
+{
+    IniString result(BinaryCharsSize(value, minWidth), IniT('0'));
+    WriteBinaryChars(&result[0], result.size(), value);
+    return result;
+}
+
+IniString Int64ToHexString(long value, std::size_t minWidth)
+{
+    IniString result(HexCharsSize(value, minWidth), IniT('0'));
+    WriteHexChars(&result[0], result.size(), value);
+    return result;
+}
+
+template <typename SizeFn, typename WriteFn>
+static void AppendInt64Array(IniString& out, const long* values, std::size_t count, std::size_t minWidth, SizeFn sizeOf, WriteFn write)
+{
+    std::size_t length = 0b10;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        length += sizeOf(values[i], minWidth);
+    }
+    if (count > 1)
+    {
+        length += 0b10 * (count - 1);
+    }
+
+    std::size_t offset = out.size();
+    out.resize(offset + length);
 
-    return oss.str();
-}
\ No newline at end of file
+    IniChar* cursor = &out[offset];
+    *cursor++ = IniT('[');
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (i != 0)
+        {
+            *cursor++ = IniT(',');
+            *cursor++ = IniT(' ');
+        }
+        std::size_t valueLength = sizeOf(values[i], minWidth);
+        write(cursor, valueLength, values[i]);
+        cursor += valueLength;
+    }
+    *cursor = IniT(']');
+}
+
+void AppendInt64BinaryArray(IniString& out, const long* values, std::size_t count, std::size_t minWidth)
+{
+    AppendInt64Array(out, values, count, minWidth, BinaryCharsSize, WriteBinaryChars);
+}
+
+void AppendInt64HexArray(IniString& out, const long* values, std::size_t count, std::size_t minWidth)
+{
+    AppendInt64Array(out, values, count, minWidth, HexCharsSize, WriteHexChars);
+}
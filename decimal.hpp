@@ -1,79 +1,173 @@
 #pragma once
 
 #include <sstream>
-#include <bitset>
+#include <string_view>
+#include <stdexcept>
+#include <cstddef>
+#include <cstring>
+#include <charconv>
+#include <climits>
 
 #include "defs.h"
 
 /**
- * @brief Parses a string representing a decimal-based number into a long integer.
- *
- * @param str The string to parse.
- * @param base The base of the number system used in the string.
- * @return The parsed long integer value.
+ * @brief Result of a non-throwing integer parse.
  */
-static long ParseDecimalBasedString(const IniString& str, int base);
+enum IniParseStatus {
+    IniParseOk = 0,         ///< The whole string was a valid number.
+    IniParseEmpty,          ///< The string was empty or contained only whitespace.
+    IniParseInvalid,        ///< The string contained a character that is not a digit of its radix.
+    IniParseOverflow        ///< The number does not fit into the target type.
+};
 
 /**
- * @brief Parses a string representing a hexadecimal number into a long integer.
+ * @brief Parses a range of characters representing a number into a long integer, without throwing.
  *
- * @param hexStr The string to parse.
- * @return The parsed long integer value.
- */
-static long ParseHexString(const IniString& hexStr);
-
-/**
- * @brief Parses a string representing a binary number into a long integer.
+ * The range is scanned once. Surrounding whitespace is ignored, an optional '+' or '-' sign is accepted,
+ * and the radix is taken from the prefix: "0x" (hexadecimal), "0b" (binary), "0o" (octal) or none (decimal).
+ * Digits may be grouped with single underscores ("1_000_000"). Runs of eight decimal digits are
+ * decoded with a single 64-bit SWAR step on little-endian targets. Prefixed values may use the full unsigned
+ * range and are read as two's complement, so the output of Int64ToHexString and Int64ToBinaryString
+ * parses back to the original value.
  *
- * @param binStr The string to parse.
- * @return The parsed long integer value.
+ * Instantiated for char and wchar_t.
+ *
+ * @param first The first character of the range.
+ * @param last One past the last character of the range.
+ * @param value The parsed value. Left untouched if parsing fails.
+ * @return IniParseOk on success, otherwise the reason of the failure.
  */
-static long ParseBinaryString(const IniString& binStr);
+template <typename CharT>
+IniParseStatus IniParseInt64Chars(const CharT* first, const CharT* last, long& value);
 
 /**
- * @brief Checks if a string represents a hexadecimal number.
+ * @brief Parses a range of characters representing a number into an unsigned integer, without throwing.
+ *
+ * Accepts the formats of IniParseInt64Chars, but decimal numbers may use the whole unsigned range too,
+ * and a minus sign is only accepted in front of zero.
  *
- * @param str The string to check.
- * @return True if the string represents a hexadecimal number, otherwise false.
+ * Instantiated for char and wchar_t.
+ *
+ * @param first The first character of the range.
+ * @param last One past the last character of the range.
+ * @param value The parsed value. Left untouched if parsing fails.
+ * @return IniParseOk on success, otherwise the reason of the failure.
  */
-static bool IsHexString(const IniString& str);
+template <typename CharT>
+IniParseStatus IniParseUInt64Chars(const CharT* first, const CharT* last, unsigned long long& value);
 
 /**
- * @brief Checks if a string represents a binary number.
+ * @brief Parses a range of characters representing a floating-point number, without throwing.
+ *
+ * Surrounding whitespace is ignored and the rest must follow the std::from_chars grammar,
+ * optionally preceded by '+'.
+ *
+ * Instantiated for char and wchar_t.
  *
- * @param str The string to check.
- * @return True if the string represents a binary number, otherwise false.
+ * @param first The first character of the range.
+ * @param last One past the last character of the range.
+ * @param value The parsed value. Left untouched if parsing fails.
+ * @return IniParseOk on success, otherwise the reason of the failure.
  */
-static bool IsBinaryString(const IniString& str);
+template <typename CharT>
+IniParseStatus IniParseDoubleChars(const CharT* first, const CharT* last, double& value);
 
 /**
- * @brief Checks if a string represents a decimal number.
+ * @brief Parses a string view representing a number into a long integer, without throwing.
  *
- * @param str The string to check.
- * @return True if the string represents a decimal number, otherwise false.
+ * See IniParseInt64Chars for the accepted formats.
+ *
+ * @param str The string to parse.
+ * @param value The parsed value. Left untouched if parsing fails.
+ * @return IniParseOk on success, otherwise the reason of the failure.
  */
-static bool IsDecimalString(const IniString& str);
+inline IniParseStatus IniTryParseInt64(std::basic_string_view<IniChar> str, long& value)
+{
+    return IniParseInt64Chars(str.data(), str.data() + str.size(), value);
+}
 
 /**
  * @brief Parses a string representing a number into a long integer.
  *
+ * See IniParseInt64Chars for the accepted formats.
+ *
  * @param str The string to parse.
  * @return The parsed long integer value.
+ * @throws std::out_of_range If the number does not fit into a long.
+ * @throws std::runtime_error If the string is not a number.
  */
 long IniParseInt64(const IniString& str);
 
+/**
+ * @brief Writes the binary representation of a long integer into a caller-provided buffer.
+ *
+ * The value is written as "0b" followed by its two's complement bits, without leading zeros
+ * unless a minimum number of digits is requested. The output is not NUL-terminated and nothing
+ * is written if the buffer is too small.
+ *
+ * @param buffer The buffer to write to.
+ * @param size The capacity of the buffer, in characters.
+ * @param value The long integer value to convert.
+ * @param minWidth The minimum number of digits after the prefix; shorter values are zero-padded.
+ * @return The length of the representation, whether or not it was written.
+ */
+std::size_t Int64ToBinaryChars(IniChar* buffer, std::size_t size, long value, std::size_t minWidth = 0);
+
+/**
+ * @brief Writes the hexadecimal representation of a long integer into a caller-provided buffer.
+ *
+ * The value is written as "0x" followed by its two's complement upper-case digits, without leading
+ * zeros unless a minimum number of digits is requested. The output is not NUL-terminated and
+ * nothing is written if the buffer is too small.
+ *
+ * @param buffer The buffer to write to.
+ * @param size The capacity of the buffer, in characters.
+ * @param value The long integer value to convert.
+ * @param minWidth The minimum number of digits after the prefix; shorter values are zero-padded.
+ * @return The length of the representation, whether or not it was written.
+ */
+std::size_t Int64ToHexChars(IniChar* buffer, std::size_t size, long value, std::size_t minWidth = 0);
+
 /**
  * @brief Converts a long integer value into a binary string representation.
  *
  * @param value The long integer value to convert.
+ * @param minWidth The minimum number of digits after the prefix; shorter values are zero-padded.
  * @return The binary string representation of the value.
  */
-IniString Int64ToBinaryString(long value);
+IniString Int64ToBinaryString(long value, std::size_t minWidth = 0);
 
 /**
  * @brief Converts a long integer value into a hexadecimal string representation.
  *
  * @param value The long integer value to convert.
+ * @param minWidth The minimum number of digits after the prefix; shorter values are zero-padded.
  * @return The hexadecimal string representation of the value.
  */
-IniString Int64ToHexString(long value);
+IniString Int64ToHexString(long value, std::size_t minWidth = 0);
+
+/**
+ * @brief Appends an array of long integers in binary representation to a string.
+ *
+ * The values are written as an array "[0b1, 0b10]" readable by IniArrayParse. The string grows
+ * once by the exact size of the output, and every value is then formatted in place.
+ *
+ * @param out The string to append to.
+ * @param values The values to convert.
+ * @param count The number of values.
+ * @param minWidth The minimum number of digits of every value.
+ */
+void AppendInt64BinaryArray(IniString& out, const long* values, std::size_t count, std::size_t minWidth = 0);
+
+/**
+ * @brief Appends an array of long integers in hexadecimal representation to a string.
+ *
+ * The values are written as an array "[0x1, 0xFF]" readable by IniArrayParse. The string grows
+ * once by the exact size of the output, and every value is then formatted in place.
+ *
+ * @param out The string to append to.
+ * @param values The values to convert.
+ * @param count The number of values.
+ * @param minWidth The minimum number of digits of every value.
+ */
+void AppendInt64HexArray(IniString& out, const long* values, std::size_t count, std::size_t minWidth = 0);
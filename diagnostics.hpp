@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Severity of a parse diagnostic.
+ */
+enum IniDiagnosticSeverity {
+    IniDiagnosticWarning = 0,   ///< The line was parsed, but probably not as intended.
+    IniDiagnosticError          ///< The line was ignored.
+};
+
+/**
+ * @brief Kind of a parse diagnostic.
+ */
+enum IniDiagnosticCode {
+    IniDiagnosticMissingEquals = 0,     ///< A line is neither a comment, a section nor a key-value pair.
+    IniDiagnosticUnterminatedSection,   ///< A line starts with '[' but does not end with ']'.
+    IniDiagnosticCarriageReturn,        ///< A line ends with '\r', which is kept in the key, value or section.
+    IniDiagnosticEmptyKey,              ///< A line starts with '='.
+    IniDiagnosticKeyWhitespace,         ///< A key starts or ends with a blank, which is kept in the key.
+    IniDiagnosticDuplicateKey           ///< A key is defined again in the same section and only one of its values is kept.
+};
+
+/**
+ * @brief Position in the parsed content, starting at line 1, column 1.
+ */
+struct IniPosition {
+    std::size_t line = 0;
+    std::size_t column = 0;
+};
+
+/**
+ * @brief A warning or error found while parsing.
+ */
+struct IniDiagnostic {
+    IniDiagnosticSeverity severity;
+    IniDiagnosticCode code;
+    IniPosition position;
+    const char* message;
+};
+
+/**
+ * @brief Side table filled by the diagnostic parse of IniParser::load() and IniParser::load_string().
+ *
+ * It holds the warnings and errors found in the content, and the position of every key-value pair.
+ * The regular parse (operator>> and operator<<) does not fill it and does not pay for it.
+ * Line numbers restart at 1 for each parse.
+ */
+template <typename CharT>
+class IniBasicDiagnostics {
+public:
+    typedef std::basic_string<CharT>                string_type;
+    typedef std::basic_string_view<CharT>           view_type;
+
+    /**
+     * @brief Get the warnings and errors, in the order of the lines.
+     *
+     * @return The diagnostics.
+     */
+    const std::vector<IniDiagnostic>& messages() const {
+        return this->diagnostics;
+    }
+
+    /**
+     * @brief Count the diagnostics of a severity.
+     *
+     * @param severity The severity to count.
+     * @return The number of diagnostics of that severity.
+     */
+    std::size_t count(IniDiagnosticSeverity severity) const {
+        std::size_t total = 0;
+        for (const auto& diagnostic : this->diagnostics) {
+            total += diagnostic.severity == severity;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Get where the value of a key-value pair was defined: its last definition, or its first one with IniDuplicateFirstWins.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The line of the pair and the column of its value, or a line of 0 if the pair was not parsed.
+     */
+    IniPosition position(view_type section, view_type key) const {
+        auto sectionIt = this->positions.find(section);
+        if (sectionIt == this->positions.end()) {
+            return IniPosition();
+        }
+        auto keyIt = sectionIt->second.find(key);
+        return keyIt != sectionIt->second.end() ? keyIt->second : IniPosition();
+    }
+
+    /**
+     * @brief Drop every diagnostic and position.
+     */
+    void clear() {
+        this->diagnostics.clear();
+        this->positions.clear();
+    }
+
+    /**
+     * @brief Record a diagnostic.
+     */
+    void report(IniDiagnosticSeverity severity, IniDiagnosticCode code, std::size_t line, std::size_t column, const char* message) {
+        IniDiagnostic diagnostic;
+        diagnostic.severity = severity;
+        diagnostic.code = code;
+        diagnostic.position.line = line;
+        diagnostic.position.column = column;
+        diagnostic.message = message;
+        this->diagnostics.push_back(diagnostic);
+    }
+
+    /**
+     * @brief Record the position of a key-value pair.
+     */
+    void locate(const string_type& section, const string_type& key, std::size_t line, std::size_t column) {
+        IniPosition& position = this->positions[section][key];
+        position.line = line;
+        position.column = column;
+    }
+
+private:
+    std::vector<IniDiagnostic> diagnostics;
+    std::map<string_type, std::map<string_type, IniPosition, std::less<>>, std::less<>> positions;
+};
+
+/**
+ * @brief Diagnostics of an IniParserA.
+ */
+typedef IniBasicDiagnostics<char>       IniDiagnosticsA;
+
+/**
+ * @brief Diagnostics of an IniParserW.
+ */
+typedef IniBasicDiagnostics<wchar_t>    IniDiagnosticsW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the diagnostics type based on whether the _UNICODE macro is defined.
+ */
+# define IniDiagnostics     IniDiagnosticsW
+
+#else
+
+/**
+ * @brief Macro that defines the diagnostics type based on whether the _UNICODE macro is defined.
+ */
+# define IniDiagnostics     IniDiagnosticsA
+
+#endif
@@ -1,32 +1,168 @@
 #include "dict.hpp"
 
-std::map<std::string, std::string> parseDictionaryA(const std::string& input)
+template <typename CharT>
+static bool IsDictSpace(CharT c)
 {
-	std::map<std::string, std::string> result;
-	std::stringstream ss(input);
-	char delimiter;
+	return c == CharT(' ') || c == CharT('\t') || c == CharT('\r') || c == CharT('\n');
+}
+
+template <typename CharT>
+static std::basic_string_view<CharT> TrimDictSpan(std::basic_string_view<CharT> span)
+{
+	std::size_t first = 0;
+	std::size_t last = span.size();
+
+	while (first < last && IsDictSpace(span[first])) {
+		++first;
+	}
+	while (last > first && IsDictSpace(span[last - 1])) {
+		--last;
+	}
+
+	span = span.substr(first, last - first);
+
+	if (span.size() >= 2 && (span.front() == CharT('"') || span.front() == CharT('\'')) && span.back() == span.front()) {
+		span = span.substr(1, span.size() - 2);
+	}
+
+	return span;
+}
+
+template <typename CharT>
+static bool PushDictEntry(std::basic_string_view<CharT> input, std::size_t begin, std::size_t colon, std::size_t end,
+	std::vector<IniBasicDictEntry<CharT>>& entries)
+{
+	if (colon == std::basic_string_view<CharT>::npos) {
+		// A separator directly followed by another one (or by the closing brace) is not an entry.
+		std::basic_string_view<CharT> key = TrimDictSpan(input.substr(begin, end - begin));
+		if (key.empty()) {
+			return true;
+		}
+		entries.push_back({ key, std::basic_string_view<CharT>() });
+		return false;
+	}
+
+	entries.push_back({
+		TrimDictSpan(input.substr(begin, colon - begin)),
+		TrimDictSpan(input.substr(colon + 1, end - colon - 1))
+	});
+	return true;
+}
+
+template <typename CharT>
+static bool ScanDictionary(std::basic_string_view<CharT> input, std::vector<IniBasicDictEntry<CharT>>& entries)
+{
+	typedef std::basic_string_view<CharT> view_type;
+
+	std::size_t pos = 0;
+	while (pos < input.size() && IsDictSpace(input[pos])) {
+		++pos;
+	}
+
+	bool braced = pos < input.size() && input[pos] == CharT('{');
+	if (braced) {
+		++pos;
+	}
+
+	bool wellFormed = true;
+	bool closed = false;
+	std::size_t depth = 0;
+	CharT quote = 0;
+	std::size_t begin = pos;
+	std::size_t colon = view_type::npos;
 
-	ss >> delimiter;
+	for (; pos < input.size(); ++pos) {
+		CharT c = input[pos];
 
-	std::string token;
-	while (std::getline(ss, token, ';')) {
-		std::string key, value;
+		if (quote) {
+			if (c == CharT('\\') && pos + 1 < input.size()) {
+				++pos;
+			}
+			else if (c == quote) {
+				quote = 0;
+			}
+			continue;
+		}
 
-		std::size_t pos = token.find(':');
+		switch (c) {
+		case CharT('"'):
+		case CharT('\''):
+			quote = c;
+			break;
+		case CharT('{'):
+		case CharT('['):
+			++depth;
+			break;
+		case CharT(']'):
+			if (depth) {
+				--depth;
+			}
+			break;
+		case CharT('}'):
+			if (depth) {
+				--depth;
+			}
+			else if (braced) {
+				closed = true;
+			}
+			else {
+				wellFormed = false;
+			}
+			break;
+		case CharT(':'):
+			if (!depth && colon == view_type::npos) {
+				colon = pos;
+			}
+			break;
+		case CharT(','):
+		case CharT(';'):
+			if (!depth) {
+				wellFormed &= PushDictEntry(input, begin, colon, pos, entries);
+				begin = pos + 1;
+				colon = view_type::npos;
+			}
+			break;
+		default:
+			break;
+		}
 
-		key = token.substr(0, pos);
-		value = token.substr(pos + 1);
+		if (closed) {
+			break;
+		}
+	}
 
-		key.erase(0, key.find_first_not_of(" "));
-		key.erase(key.find_last_not_of(" ") + 1);
-		value.erase(0, value.find_first_not_of(" "));
-		value.erase(value.find_last_not_of(" ") + 1);
+	wellFormed &= PushDictEntry(input, begin, colon, pos, entries);
 
-		if (!value.empty() && value.back() == '}') {
-			value.pop_back();
+	if (closed) {
+		for (++pos; pos < input.size(); ++pos) {
+			if (!IsDictSpace(input[pos])) {
+				return false;
+			}
 		}
+	}
+
+	return wellFormed && !quote && !depth && closed == braced;
+}
+
+bool parseDictionaryViewA(std::string_view input, std::vector<IniDictEntryA>& entries)
+{
+	return ScanDictionary(input, entries);
+}
+
+bool parseDictionaryViewW(std::wstring_view input, std::vector<IniDictEntryW>& entries)
+{
+	return ScanDictionary(input, entries);
+}
 
-		result[key] = value;
+std::map<std::string, std::string> parseDictionaryA(const std::string& input)
+{
+	std::map<std::string, std::string> result;
+	std::vector<IniDictEntryA> entries;
+
+	parseDictionaryViewA(input, entries);
+
+	for (const auto& entry : entries) {
+		result[std::string(entry.key)].assign(entry.value.data(), entry.value.size());
 	}
 
 	return result;
@@ -34,65 +170,162 @@ std::map<std::string, std::string> parseDictionaryA(const std::string& input)
 
 std::map<std::wstring, std::wstring> parseDictionaryW(const std::wstring& input) {
 	std::map<std::wstring, std::wstring> result;
-	std::wstringstream ss(input);
-	wchar_t delimiter;
+	std::vector<IniDictEntryW> entries;
 
-	ss >> delimiter;
+	parseDictionaryViewW(input, entries);
 
-	std::wstring token;
-	while (std::getline(ss, token, L';')) {
-		std::wstring key, value;
+	for (const auto& entry : entries) {
+		result[std::wstring(entry.key)].assign(entry.value.data(), entry.value.size());
+	}
 
-		std::size_t pos = token.find(L':');
+	return result;
+}
 
-		key = token.substr(0, pos);
-		value = token.substr(pos + 1);
+template <typename CharT>
+static std::basic_string_view<CharT> DictEntryKey(const std::pair<const std::basic_string<CharT>, std::basic_string<CharT>>& pair)
+{
+	return pair.first;
+}
 
-		key.erase(0, key.find_first_not_of(L" "));
-		key.erase(key.find_last_not_of(L" ") + 1);
-		value.erase(0, value.find_first_not_of(L" "));
-		value.erase(value.find_last_not_of(L" ") + 1);
+template <typename CharT>
+static std::basic_string_view<CharT> DictEntryKey(const IniBasicDictEntry<CharT>& entry)
+{
+	return entry.key;
+}
 
-		if (!value.empty() && value.back() == '}') {
-			value.pop_back();
-		}
+template <typename CharT>
+static std::basic_string_view<CharT> DictEntryValue(const std::pair<const std::basic_string<CharT>, std::basic_string<CharT>>& pair)
+{
+	return pair.second;
+}
+
+template <typename CharT>
+static std::basic_string_view<CharT> DictEntryValue(const IniBasicDictEntry<CharT>& entry)
+{
+	return entry.value;
+}
+
+template <typename CharT, typename Container>
+static std::size_t DictionaryStringSize(const Container& entries)
+{
+	std::size_t size = 2;
 
-		result[key] = value;
+	for (const auto& entry : entries) {
+		size += DictEntryKey<CharT>(entry).size() + 2 + DictEntryValue<CharT>(entry).size();
+	}
+	if (entries.size() > 1) {
+		size += 2 * (entries.size() - 1);
 	}
 
-	return result;
+	return size;
 }
 
-std::string dictionaryToStringA(const std::map<std::string, std::string>& dictionary)
+template <typename CharT, typename Container>
+static CharT* WriteDictionary(CharT* out, const Container& entries)
 {
-	std::string result = "{";
+	*out++ = CharT('{');
 
-	for (const auto& pair : dictionary) {
-		result += pair.first + ": " + pair.second + ';' + " ";
-	}
+	bool first = true;
+	for (const auto& entry : entries) {
+		if (!first) {
+			*out++ = CharT(IniDictSplitCharA);
+			*out++ = CharT(' ');
+		}
+		first = false;
+
+		std::basic_string_view<CharT> key = DictEntryKey<CharT>(entry);
+		std::basic_string_view<CharT> value = DictEntryValue<CharT>(entry);
 
-	if (!result.empty()) {
-		result.pop_back();
-		result.pop_back();
+		out = std::copy(key.begin(), key.end(), out);
+		*out++ = CharT(':');
+		*out++ = CharT(' ');
+		out = std::copy(value.begin(), value.end(), out);
 	}
 
-	result += "}";
+	*out++ = CharT('}');
+	return out;
+}
+
+template <typename CharT, typename Container>
+static void AppendDictionary(std::basic_string<CharT>& out, const Container& entries)
+{
+	std::size_t offset = out.size();
+	out.resize(offset + DictionaryStringSize<CharT>(entries));
+	WriteDictionary(&out[offset], entries);
+}
+
+std::string dictionaryToStringA(const std::map<std::string, std::string>& dictionary)
+{
+	std::string result;
+	AppendDictionary(result, dictionary);
 	return result;
 }
 
 std::wstring dictionaryToStringW(const std::map<std::wstring, std::wstring>& dictionary)
 {
-	std::wstring result = L"{";
+	std::wstring result;
+	AppendDictionary(result, dictionary);
+	return result;
+}
+
+std::string dictionaryToStringA(const std::vector<IniDictEntryA>& entries)
+{
+	std::string result;
+	AppendDictionary(result, entries);
+	return result;
+}
+
+std::wstring dictionaryToStringW(const std::vector<IniDictEntryW>& entries)
+{
+	std::wstring result;
+	AppendDictionary(result, entries);
+	return result;
+}
+
+std::size_t dictionaryStringSizeA(const std::map<std::string, std::string>& dictionary)
+{
+	return DictionaryStringSize<char>(dictionary);
+}
 
-	for (const auto& pair : dictionary) {
-		result += pair.first + L": " + pair.second + L';' + L" ";
+std::size_t dictionaryStringSizeW(const std::map<std::wstring, std::wstring>& dictionary)
+{
+	return DictionaryStringSize<wchar_t>(dictionary);
+}
+
+std::size_t writeDictionaryA(char* buffer, std::size_t size, const std::map<std::string, std::string>& dictionary)
+{
+	std::size_t required = DictionaryStringSize<char>(dictionary);
+	if (required <= size) {
+		WriteDictionary(buffer, dictionary);
 	}
+	return required;
+}
 
-	if (!result.empty()) {
-		result.pop_back();
-		result.pop_back();
+std::size_t writeDictionaryW(wchar_t* buffer, std::size_t size, const std::map<std::wstring, std::wstring>& dictionary)
+{
+	std::size_t required = DictionaryStringSize<wchar_t>(dictionary);
+	if (required <= size) {
+		WriteDictionary(buffer, dictionary);
 	}
+	return required;
+}
 
-	result += L"}";
-	return result;
-}
\ No newline at end of file
+void appendDictionaryA(std::string& out, const std::map<std::string, std::string>& dictionary)
+{
+	AppendDictionary(out, dictionary);
+}
+
+void appendDictionaryW(std::wstring& out, const std::map<std::wstring, std::wstring>& dictionary)
+{
+	AppendDictionary(out, dictionary);
+}
+
+void appendDictionaryA(std::string& out, const std::vector<IniDictEntryA>& entries)
+{
+	AppendDictionary(out, entries);
+}
+
+void appendDictionaryW(std::wstring& out, const std::vector<IniDictEntryW>& entries)
+{
+	AppendDictionary(out, entries);
+}
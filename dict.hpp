@@ -1,10 +1,66 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <map>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <type_traits>
 
 #include "defs.h"
+#include "decimal.hpp"
+
+/**
+ * @brief A single key-value pair of an inline dictionary.
+ *
+ * Both members point into the string the dictionary was scanned from, so an entry is only valid
+ * while that string is alive and unmodified. Surrounding whitespace and enclosing quotes are
+ * already stripped from both spans.
+ */
+template <typename CharT>
+struct IniBasicDictEntry {
+	std::basic_string_view<CharT> key;
+	std::basic_string_view<CharT> value;
+};
+
+/**
+ * @brief Dictionary entry type for ASCII strings.
+ */
+typedef IniBasicDictEntry<char>		IniDictEntryA;
+
+/**
+ * @brief Dictionary entry type for Unicode strings.
+ */
+typedef IniBasicDictEntry<wchar_t>	IniDictEntryW;
+
+/**
+ * @brief Scan a string representing a dictionary into a flat list of key-value spans.
+ *
+ * This function scans the input "{key1: value1, key2: value2}" once, without copying any of its characters.
+ * Entries are separated by ',' or ';'. Separators and colons inside quoted ("..." or '...') or nested
+ * ({...} or [...]) values do not split the entry, so values may themselves be arrays or dictionaries.
+ * Duplicate keys are kept in input order.
+ *
+ * @param input The input string representing the dictionary.
+ * @param entries The vector the parsed entries are appended to.
+ * @return True if the input was well-formed, false otherwise. Entries scanned before an error are kept.
+ */
+bool parseDictionaryViewA(std::string_view input, std::vector<IniDictEntryA>& entries);
+
+/**
+ * @brief Scan a Unicode string representing a dictionary into a flat list of key-value spans.
+ *
+ * This function is the Unicode counterpart of parseDictionaryViewA and follows the same rules.
+ *
+ * @param input The Unicode input string representing the dictionary.
+ * @param entries The vector the parsed entries are appended to.
+ * @return True if the input was well-formed, false otherwise. Entries scanned before an error are kept.
+ */
+bool parseDictionaryViewW(std::wstring_view input, std::vector<IniDictEntryW>& entries);
 
 /**
  * @brief Parse a string representing a dictionary into a std::map<std::string, std::string>.
@@ -12,6 +68,7 @@
  * This function parses a string input representing a dictionary of key-value pairs into a std::map<std::string, std::string>.
  * The input string should have the format "{key1: value1, key2: value2}".
  * Each key and value are trimmed of leading and trailing whitespaces.
+ * If a key occurs more than once, the last value wins.
  *
  * @param input The input string representing the dictionary.
  * @return A std::map<std::string, std::string> containing the parsed key-value pairs.
@@ -24,6 +81,7 @@ std::map<std::string, std::string> parseDictionaryA(const std::string& input);
  * This function parses a Unicode string input representing a dictionary of key-value pairs into a std::map<std::wstring, std::wstring>.
  * The input string should have the format "{key1: value1, key2: value2}".
  * Each key and value are trimmed of leading and trailing whitespaces.
+ * If a key occurs more than once, the last value wins.
  *
  * @param input The Unicode input string representing the dictionary.
  * @return A std::map<std::wstring, std::wstring> containing the parsed key-value pairs.
@@ -52,6 +110,387 @@ std::string dictionaryToStringA(const std::map<std::string, std::string>& dictio
  */
 std::wstring dictionaryToStringW(const std::map<std::wstring, std::wstring>& dictionary);
 
+/**
+ * @brief Convert a list of dictionary entries into a string representation of a dictionary.
+ *
+ * Entries are written in the order given, so a dictionary scanned with parseDictionaryViewA
+ * is written back with its original order and duplicates.
+ *
+ * @param entries The entries to convert.
+ * @return A string representation of the dictionary.
+ */
+std::string dictionaryToStringA(const std::vector<IniDictEntryA>& entries);
+
+/**
+ * @brief Convert a list of dictionary entries into a Unicode string representation of a dictionary.
+ *
+ * Entries are written in the order given, so a dictionary scanned with parseDictionaryViewW
+ * is written back with its original order and duplicates.
+ *
+ * @param entries The entries to convert.
+ * @return A Unicode string representation of the dictionary.
+ */
+std::wstring dictionaryToStringW(const std::vector<IniDictEntryW>& entries);
+
+/**
+ * @brief Compute the exact length of the string representation of a dictionary.
+ *
+ * @param dictionary The dictionary.
+ * @return The number of characters dictionaryToStringA would produce.
+ */
+std::size_t dictionaryStringSizeA(const std::map<std::string, std::string>& dictionary);
+
+/**
+ * @brief Compute the exact length of the Unicode string representation of a dictionary.
+ *
+ * @param dictionary The dictionary.
+ * @return The number of characters dictionaryToStringW would produce.
+ */
+std::size_t dictionaryStringSizeW(const std::map<std::wstring, std::wstring>& dictionary);
+
+/**
+ * @brief Write the string representation of a dictionary into a caller-provided buffer.
+ *
+ * The output is not NUL-terminated. Nothing is written if the buffer is too small, so the
+ * return value can be used to size the buffer and call the function again.
+ *
+ * @param buffer The buffer to write to.
+ * @param size The capacity of the buffer, in characters.
+ * @param dictionary The dictionary.
+ * @return The length of the representation, whether or not it was written.
+ */
+std::size_t writeDictionaryA(char* buffer, std::size_t size, const std::map<std::string, std::string>& dictionary);
+
+/**
+ * @brief Write the Unicode string representation of a dictionary into a caller-provided buffer.
+ *
+ * The output is not NUL-terminated. Nothing is written if the buffer is too small, so the
+ * return value can be used to size the buffer and call the function again.
+ *
+ * @param buffer The buffer to write to.
+ * @param size The capacity of the buffer, in characters.
+ * @param dictionary The dictionary.
+ * @return The length of the representation, whether or not it was written.
+ */
+std::size_t writeDictionaryW(wchar_t* buffer, std::size_t size, const std::map<std::wstring, std::wstring>& dictionary);
+
+/**
+ * @brief Append the string representation of a dictionary to a string.
+ *
+ * The string grows once by the exact size of the representation, which is then written in a single pass.
+ *
+ * @param out The string to append to.
+ * @param dictionary The dictionary.
+ */
+void appendDictionaryA(std::string& out, const std::map<std::string, std::string>& dictionary);
+
+/**
+ * @brief Append the Unicode string representation of a dictionary to a string.
+ *
+ * The string grows once by the exact size of the representation, which is then written in a single pass.
+ *
+ * @param out The string to append to.
+ * @param dictionary The dictionary.
+ */
+void appendDictionaryW(std::wstring& out, const std::map<std::wstring, std::wstring>& dictionary);
+
+/**
+ * @brief Append the string representation of a list of dictionary entries to a string.
+ *
+ * @param out The string to append to.
+ * @param entries The entries to convert.
+ */
+void appendDictionaryA(std::string& out, const std::vector<IniDictEntryA>& entries);
+
+/**
+ * @brief Append the Unicode string representation of a list of dictionary entries to a string.
+ *
+ * @param out The string to append to.
+ * @param entries The entries to convert.
+ */
+void appendDictionaryW(std::wstring& out, const std::vector<IniDictEntryW>& entries);
+
+/**
+ * @brief Convert a dictionary value to a typed value.
+ *
+ * Strings are copied as they are. Booleans accept "true"/"false" and "1"/"0". Signed integers are read
+ * with IniParseInt64Chars, unsigned ones with IniParseUInt64Chars, and must fit into the target type.
+ * Floating-point values are read with IniParseDoubleChars. The whole span must be consumed for the conversion to succeed.
+ *
+ * @param value The span to convert.
+ * @param out The converted value. Left untouched if the conversion fails.
+ * @return True if the conversion succeeded, false otherwise.
+ */
+template <typename CharT, typename __T__>
+bool IniDictConvert(std::basic_string_view<CharT> value, __T__& out) {
+	if constexpr (std::is_same_v<__T__, std::basic_string_view<CharT>>) {
+		out = value;
+		return true;
+	}
+	else if constexpr (std::is_same_v<__T__, std::basic_string<CharT>>) {
+		out.assign(value.data(), value.size());
+		return true;
+	}
+	else if constexpr (std::is_same_v<__T__, bool>) {
+		if (value.size() == 1 && (value[0] == CharT('1') || value[0] == CharT('0'))) {
+			out = value[0] == CharT('1');
+			return true;
+		}
+		static const CharT trueText[] = { 't', 'r', 'u', 'e' };
+		static const CharT falseText[] = { 'f', 'a', 'l', 's', 'e' };
+		if (value == std::basic_string_view<CharT>(trueText, 4)) {
+			out = true;
+			return true;
+		}
+		if (value == std::basic_string_view<CharT>(falseText, 5)) {
+			out = false;
+			return true;
+		}
+		return false;
+	}
+	else {
+		static_assert(std::is_arithmetic_v<__T__>, "IniDictConvert: unsupported target type");
+
+		if constexpr (std::is_integral_v<__T__> && std::is_unsigned_v<__T__>) {
+			unsigned long long parsed = 0;
+			if (IniParseUInt64Chars(value.data(), value.data() + value.size(), parsed) != IniParseOk ||
+				parsed > std::numeric_limits<__T__>::max()) {
+				return false;
+			}
+			out = static_cast<__T__>(parsed);
+			return true;
+		}
+		else if constexpr (std::is_integral_v<__T__>) {
+			long parsed = 0;
+			if (IniParseInt64Chars(value.data(), value.data() + value.size(), parsed) != IniParseOk) {
+				return false;
+			}
+			if (parsed < std::numeric_limits<__T__>::min() || parsed > std::numeric_limits<__T__>::max()) {
+				return false;
+			}
+			out = static_cast<__T__>(parsed);
+			return true;
+		}
+		else {
+			double parsed = 0;
+			if (IniParseDoubleChars(value.data(), value.data() + value.size(), parsed) != IniParseOk) {
+				return false;
+			}
+			out = static_cast<__T__>(parsed);
+			return true;
+		}
+	}
+}
+
+/**
+ * @brief Overloaded scanner selecting the ASCII or Unicode implementation by argument type.
+ */
+inline bool IniDictScan(std::string_view input, std::vector<IniDictEntryA>& entries) {
+	return parseDictionaryViewA(input, entries);
+}
+
+/**
+ * @brief Overloaded scanner selecting the ASCII or Unicode implementation by argument type.
+ */
+inline bool IniDictScan(std::wstring_view input, std::vector<IniDictEntryW>& entries) {
+	return parseDictionaryViewW(input, entries);
+}
+
+/**
+ * @brief A read-only, non-owning view of an inline dictionary with typed access.
+ *
+ * The dictionary is scanned once into a flat vector of key-value spans. Small dictionaries are
+ * searched linearly, which beats hashing for a handful of short keys; once a dictionary has more than
+ * IniBasicDict::IndexThreshold entries a hash index is built while it is scanned.
+ * Lookups of duplicate keys return the last occurrence, matching parseDictionaryA.
+ *
+ * The string passed to the constructor must outlive the view. Once scanned, the view is not modified
+ * by lookups, so const members can be called from several threads.
+ */
+template <typename CharT>
+class IniBasicDict {
+public:
+	typedef std::basic_string_view<CharT>	view_type;
+	typedef IniBasicDictEntry<CharT>		entry_type;
+
+	/**
+	 * @brief Number of entries above which lookups go through a hash index.
+	 */
+	static constexpr std::size_t IndexThreshold = 16;
+
+	/**
+	 * @brief Default constructor. Creates an empty dictionary.
+	 */
+	IniBasicDict() : wellFormed(true) {}
+
+	/**
+	 * @brief Construct a dictionary view by scanning the input.
+	 *
+	 * @param input The string representing the dictionary. It must outlive the view.
+	 */
+	explicit IniBasicDict(view_type input) : wellFormed(true) {
+		this->parse(input);
+	}
+
+	/**
+	 * @brief Construct a dictionary view by scanning a NUL-terminated string.
+	 *
+	 * @param input The string representing the dictionary. It must outlive the view.
+	 */
+	explicit IniBasicDict(const CharT* input) : IniBasicDict(view_type(input)) {}
+
+	/**
+	 * @brief Temporaries are rejected, since the view would dangle as soon as the constructor returns.
+	 */
+	explicit IniBasicDict(std::basic_string<CharT>&&) = delete;
+
+	/**
+	 * @brief Scan a new input, replacing the current entries.
+	 *
+	 * @param input The string representing the dictionary. It must outlive the view.
+	 * @return True if the input was well-formed, false otherwise.
+	 */
+	bool parse(view_type input) {
+		this->entries.clear();
+		this->index.clear();
+		this->wellFormed = IniDictScan(input, this->entries);
+
+		if (this->entries.size() > IndexThreshold) {
+			this->index.reserve(this->entries.size());
+			for (std::size_t i = 0; i < this->entries.size(); ++i) {
+				this->index[this->entries[i].key] = i;
+			}
+		}
+		return this->wellFormed;
+	}
+
+	/**
+	 * @brief Check whether the last scanned input was well-formed.
+	 *
+	 * @return True if no syntax error was found, false otherwise.
+	 */
+	bool valid() const {
+		return this->wellFormed;
+	}
+
+	/**
+	 * @brief Get the number of entries, duplicates included.
+	 *
+	 * @return The number of entries.
+	 */
+	std::size_t size() const {
+		return this->entries.size();
+	}
+
+	/**
+	 * @brief Check whether the dictionary has no entries.
+	 *
+	 * @return True if the dictionary is empty, false otherwise.
+	 */
+	bool empty() const {
+		return this->entries.empty();
+	}
+
+	/**
+	 * @brief Iterators over the entries in input order.
+	 */
+	typename std::vector<entry_type>::const_iterator begin() const {
+		return this->entries.begin();
+	}
+
+	/**
+	 * @brief Iterators over the entries in input order.
+	 */
+	typename std::vector<entry_type>::const_iterator end() const {
+		return this->entries.end();
+	}
+
+	/**
+	 * @brief Find the entry for a key.
+	 *
+	 * @param key The key to look up.
+	 * @return A pointer to the last entry with this key, or nullptr if the key does not exist.
+	 */
+	const entry_type* find(view_type key) const {
+		if (!this->index.empty()) {
+			auto it = this->index.find(key);
+			return it != this->index.end() ? &this->entries[it->second] : nullptr;
+		}
+
+		for (std::size_t i = this->entries.size(); i-- > 0;) {
+			if (this->entries[i].key == key) {
+				return &this->entries[i];
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * @brief Check if a key exists.
+	 *
+	 * @param key The key to check.
+	 * @return True if the key exists, false otherwise.
+	 */
+	bool contains(view_type key) const {
+		return this->find(key) != nullptr;
+	}
+
+	/**
+	 * @brief Get the raw value of a key.
+	 *
+	 * @param key The key to look up.
+	 * @param fallback The value returned if the key does not exist.
+	 * @return The value span of the key, or the fallback.
+	 */
+	view_type get(view_type key, view_type fallback = view_type()) const {
+		const entry_type* entry = this->find(key);
+		return entry ? entry->value : fallback;
+	}
+
+	/**
+	 * @brief Get the value of a key converted to a typed value.
+	 *
+	 * See IniDictConvert for the accepted formats.
+	 *
+	 * @param key The key to look up.
+	 * @param out The converted value. Left untouched if the key is missing or cannot be converted.
+	 * @return True if the key exists and was converted, false otherwise.
+	 */
+	template <typename __T__>
+	bool get(view_type key, __T__& out) const {
+		const entry_type* entry = this->find(key);
+		return entry && IniDictConvert<CharT>(entry->value, out);
+	}
+
+	/**
+	 * @brief Get the value of a key converted to a typed value, or a fallback.
+	 *
+	 * @param key The key to look up.
+	 * @param fallback The value returned if the key is missing or cannot be converted.
+	 * @return The converted value, or the fallback.
+	 */
+	template <typename __T__>
+	__T__ as(view_type key, __T__ fallback = __T__()) const {
+		this->get(key, fallback);
+		return fallback;
+	}
+
+private:
+	std::vector<entry_type> entries;
+	std::unordered_map<view_type, std::size_t> index;
+	bool wellFormed;
+};
+
+/**
+ * @brief Dictionary view type for ASCII strings.
+ */
+typedef IniBasicDict<char>		IniDictA;
+
+/**
+ * @brief Dictionary view type for Unicode strings.
+ */
+typedef IniBasicDict<wchar_t>	IniDictW;
+
 /**
 * @brief Separator character for INI format dictionaries.
 */
@@ -72,6 +511,18 @@ std::wstring dictionaryToStringW(const std::map<std::wstring, std::wstring>& dic
   * @brief Macro defining the function name for converting a dictionary to a Unicode string representation.
   */
 # define IniDictToStr			dictionaryToStringW
+ /**
+  * @brief Macro defining the function name for appending a dictionary to a Unicode string.
+  */
+# define IniDictAppend			appendDictionaryW
+ /**
+  * @brief Macro defining the function name for scanning a Unicode dictionary into key-value spans.
+  */
+# define IniDictParseView		parseDictionaryViewW
+ /**
+  * @brief Macro defining the dictionary view type for Unicode strings.
+  */
+# define IniDict				IniDictW
 
 #else
 
@@ -83,5 +534,17 @@ std::wstring dictionaryToStringW(const std::map<std::wstring, std::wstring>& dic
   * @brief Macro defining the function name for converting a dictionary to a string representation.
   */
 # define IniDictToStr			dictionaryToStringA
+ /**
+  * @brief Macro defining the function name for appending a dictionary to a string.
+  */
+# define IniDictAppend			appendDictionaryA
+ /**
+  * @brief Macro defining the function name for scanning a dictionary into key-value spans.
+  */
+# define IniDictParseView		parseDictionaryViewA
+ /**
+  * @brief Macro defining the dictionary view type for ASCII strings.
+  */
+# define IniDict				IniDictA
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,70 @@
+#include "frozen.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<const unsigned char> IniMapFile(const std::filesystem::path& path, std::size_t& size)
+{
+#if defined(_WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) {
+		return nullptr;
+	}
+
+	// The view keeps the mapping alive once both handles are closed.
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view) {
+		return nullptr;
+	}
+
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	return std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(view), [](const unsigned char* p) {
+		UnmapViewOfFile(p);
+	});
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return nullptr;
+	}
+
+	std::size_t length = static_cast<std::size_t>(info.st_size);
+	void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return nullptr;
+	}
+
+	size = length;
+	return std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(view), [length](const unsigned char* p) {
+		munmap(const_cast<unsigned char*>(p), length);
+	});
+#endif
+}
@@ -0,0 +1,683 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <vector>
+#include                    <string>
+#include                    <string_view>
+#include                    <optional>
+#include                    <unordered_map>
+#include                    <algorithm>
+#include                    <atomic>
+#include                    <tuple>
+#include                    <cstdint>
+#include                    <stdexcept>
+#include                    <memory>
+#include                    <cstring>
+#include                    <fstream>
+#include                    <filesystem>
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+/**
+ * @brief Records how often each key of a parser is read.
+ *
+ * The profile wraps a parser and forwards lookups to it, counting them per key. The counts are keyed by
+ * the address of the stored value, which is stable as long as the key is not removed. The table holds a
+ * counter for every key of the parser from the start, so counting an access neither allocates nor locks:
+ * it finds the counter and increments it atomically, and the profile can be shared between threads while
+ * it records. Keys added to the parser later are not counted; reset the profile, while no thread reads
+ * through it, after adding or removing keys.
+ */
+template <typename Parser>
+class IniBasicAccessProfile {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+    typedef std::basic_string_view<char_type>       view_type;
+
+    /**
+     * @brief Constructor. Starts an empty profile, with a counter for every key of the parser.
+     *
+     * @param target The parser to read from. It must outlive the profile.
+     */
+    explicit IniBasicAccessProfile(const Parser& target) : target(target) {
+        this->reset();
+    }
+
+    /**
+     * @brief Find the value of a key and count the access.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return A pointer to the stored value, or nullptr if the key does not exist.
+     */
+    const string_type* lookup(view_type section, view_type key) {
+        const string_type* value = this->target.lookup(section, key);
+        if (value) {
+            auto it = this->counts.find(value);
+            if (it != this->counts.end()) {
+                it->second.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Get the value of a key in a section and count the access.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The value of the key-value pair, or an empty string if the key does not exist.
+     */
+    template <typename __T__ = string_type>
+    __T__ get(const char_type* section, const char_type* key) {
+        const string_type* value = this->lookup(section, key);
+        return static_cast<__T__>(value ? *value : string_type());
+    }
+
+    /**
+     * @brief Get the number of recorded reads of a key.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The number of reads since the profile was created or reset.
+     */
+    std::uint64_t count(view_type section, view_type key) const {
+        return this->count(this->target.lookup(section, key));
+    }
+
+    /**
+     * @brief Get the number of recorded reads of a stored value.
+     *
+     * @param value A pointer to a value stored in the parser.
+     * @return The number of reads since the profile was created or reset.
+     */
+    std::uint64_t count(const string_type* value) const {
+        auto it = this->counts.find(value);
+        return it != this->counts.end() ? it->second.load(std::memory_order_relaxed) : 0;
+    }
+
+    /**
+     * @brief Forget every recorded read and make a counter for every key the parser holds now.
+     *
+     * No thread may read through the profile during the call.
+     */
+    void reset() {
+        std::size_t size = 0;
+        for (const auto& section : this->target.view()) {
+            size += section.second.size();
+        }
+
+        this->counts.clear();
+        this->counts.reserve(size);
+        for (const auto& section : this->target.view()) {
+            for (const auto& pair : section.second) {
+                this->counts.emplace(std::piecewise_construct, std::forward_as_tuple(&pair.second), std::forward_as_tuple(0));
+            }
+        }
+    }
+
+    /**
+     * @brief Get the profiled parser.
+     */
+    const Parser& parser() const {
+        return this->target;
+    }
+
+private:
+    const Parser& target;
+
+    /**
+     * @brief A counter per stored value. Its shape only changes in reset(), so lookups may search it concurrently.
+     */
+    std::unordered_map<const string_type*, std::atomic<std::uint64_t>> counts;
+};
+
+/**
+ * @brief Map a whole file into memory, read-only.
+ *
+ * @param path The path of the file.
+ * @param size Receives the size of the file.
+ * @return The mapped bytes, unmapped when the last copy of the pointer is released, or nullptr on failure.
+ */
+std::shared_ptr<const unsigned char> IniMapFile(const std::filesystem::path& path, std::size_t& size);
+
+/**
+ * @brief Immutable, read-optimized copy of a parser.
+ *
+ * Freezing copies every key-value pair into a single position-independent image built for lookups:
+ *
+ * - a table of 32-byte entries, starting on a cache line, ordered from the most to the least read key
+ *   so the hottest keys share the first cache lines;
+ * - a character pool written in the same order, where the section and key of an entry are stored
+ *   next to each other so they are compared in one pass;
+ * - a minimal perfect hash (hash and displace, CHD) that maps every (section, key) pair to its own
+ *   slot, so a lookup hashes once and compares a single entry.
+ *
+ * The image can be written with save() and mapped back with open(), for example to build the
+ * document offline and share it between processes. Images use the byte order and wchar_t size of
+ * the machine that built them; open() rejects images it cannot read.
+ *
+ * A frozen document cannot be modified. It does not refer to the parser it was built from, and can be
+ * read from any number of threads without locking. Copies share the same image.
+ */
+template <typename CharT>
+class IniBasicFrozen {
+public:
+    typedef CharT                                   char_type;
+    typedef std::basic_string<CharT>                string_type;
+    typedef std::basic_string_view<CharT>           view_type;
+
+    /**
+     * @brief Average number of keys per bucket of the perfect hash.
+     */
+    static constexpr std::size_t BucketLoad = 4;
+
+    /**
+     * @brief Default constructor. Creates an empty document.
+     */
+    IniBasicFrozen() : header(nullptr), entries(nullptr), displacements(nullptr), slots(nullptr), pool(nullptr) {}
+
+    /**
+     * @brief Freeze a parser.
+     *
+     * @param ini The parser to copy.
+     */
+    template <typename Parser>
+    explicit IniBasicFrozen(const Parser& ini) : IniBasicFrozen() {
+        this->build(ini.view(), [](const string_type*) { return std::uint64_t(0); });
+    }
+
+    /**
+     * @brief Freeze a parser, placing its most read keys first.
+     *
+     * @param profile The access profile recorded over the parser to copy.
+     */
+    template <typename Parser>
+    explicit IniBasicFrozen(const IniBasicAccessProfile<Parser>& profile) : IniBasicFrozen() {
+        this->build(profile.parser().view(), [&](const string_type* value) { return profile.count(value); });
+    }
+
+    /**
+     * @brief Find the value of a key.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The value, which lives as long as the image, or std::nullopt if the key does not exist.
+     */
+    std::optional<view_type> lookup(view_type section, view_type key) const {
+        if (!this->header || this->header->entryCount == 0) {
+            return std::nullopt;
+        }
+
+        std::uint64_t hash = Hash(section, key);
+        const Entry& entry = this->entries[this->slots[this->slot(hash)]];
+
+        if (entry.hash != hash || entry.sectionLength != section.size() || entry.keyLength != key.size()) {
+            return std::nullopt;
+        }
+
+        // The section and key of an entry are adjacent in the pool.
+        const CharT* text = this->pool + entry.key;
+        if (!std::equal(section.begin(), section.end(), text) || !std::equal(key.begin(), key.end(), text + section.size())) {
+            return std::nullopt;
+        }
+        return view_type(this->pool + entry.value, entry.valueLength);
+    }
+
+    /**
+     * @brief Get the value of a key in a section.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The value of the key-value pair, or an empty string if the key does not exist.
+     */
+    template <typename __T__ = string_type>
+    __T__ get(const char_type* section, const char_type* key) const {
+        std::optional<view_type> value = this->lookup(section, key);
+        return static_cast<__T__>(value ? string_type(*value) : string_type());
+    }
+
+    /**
+     * @brief Check if a key exists in a section.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return True if the key exists with a non-empty value, as for the parser, false otherwise.
+     */
+    bool exist(view_type section, view_type key) const {
+        std::optional<view_type> value = this->lookup(section, key);
+        return value.has_value() && !value->empty();
+    }
+
+    /**
+     * @brief Get the number of key-value pairs.
+     *
+     * @return The number of key-value pairs.
+     */
+    std::size_t size() const {
+        return this->header ? this->header->entryCount : 0;
+    }
+
+    /**
+     * @brief Visit every key-value pair, from the most to the least read key.
+     *
+     * @param fn Called as fn(section, key, value) with string views into the image.
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t i = 0; i < this->size(); ++i) {
+            const Entry& entry = this->entries[i];
+            fn(view_type(this->pool + entry.key, entry.sectionLength),
+                view_type(this->pool + entry.key + entry.sectionLength, entry.keyLength),
+                view_type(this->pool + entry.value, entry.valueLength));
+        }
+    }
+
+    /**
+     * @brief Write the image to a file.
+     *
+     * @param filename The name of the file to write to.
+     * @return True if the file was successfully written, false otherwise.
+     */
+    bool save(const char_type* filename) const {
+        std::ofstream file{ std::filesystem::path(filename), std::ios::binary };
+        if (!file.is_open()) {
+            return false;
+        }
+        if (this->header) {
+            file.write(reinterpret_cast<const char*>(this->image.get()), static_cast<std::streamsize>(this->header->imageSize));
+        }
+        return static_cast<bool>(file.flush());
+    }
+
+    /**
+     * @brief Map an image written by save().
+     *
+     * The file is mapped read-only rather than read, so opening is fast and processes mapping
+     * the same file share its pages. The file must not be modified while it is mapped.
+     *
+     * @param filename The name of the file to map.
+     * @return True if the file was mapped and is a valid image, false otherwise. On failure, the document is left unchanged.
+     */
+    bool open(const char_type* filename) {
+        std::size_t size = 0;
+        std::shared_ptr<const unsigned char> mapped = IniMapFile(std::filesystem::path(filename), size);
+        return mapped && this->attach(std::move(mapped), size);
+    }
+
+    /**
+     * @brief Get the image of the document.
+     *
+     * @return The first byte of the image, or nullptr for an empty document built by the default constructor.
+     */
+    const void* data() const {
+        return this->image.get();
+    }
+
+    /**
+     * @brief Get the size of the image, in bytes.
+     */
+    std::size_t image_size() const {
+        return this->header ? static_cast<std::size_t>(this->header->imageSize) : 0;
+    }
+
+private:
+    static constexpr char Magic[8] = { 'X', 'I', 'N', 'I', 'F', 'R', 'Z', '1' };
+
+    static constexpr std::size_t CacheLine = 64;
+
+    /**
+     * @brief First bytes of an image. Every offset is relative to the start of the image.
+     */
+    struct Header {
+        char magic[8];
+        std::uint32_t charSize;
+        std::uint32_t entryCount;
+        std::uint32_t bucketCount;
+        std::uint32_t reserved;
+        std::uint64_t seed;
+        std::uint64_t entriesOffset;
+        std::uint64_t displacementsOffset;
+        std::uint64_t slotsOffset;
+        std::uint64_t poolOffset;
+        std::uint64_t poolLength;
+        std::uint64_t imageSize;
+    };
+
+    /**
+     * @brief A key-value pair: its full hash, then the position of its strings in the pool.
+     *
+     * key is the offset of the section, immediately followed by the key.
+     */
+    struct alignas(32) Entry {
+        std::uint64_t hash;
+        std::uint32_t key;
+        std::uint32_t sectionLength;
+        std::uint32_t keyLength;
+        std::uint32_t value;
+        std::uint32_t valueLength;
+    };
+
+    static_assert(sizeof(Entry) == 32, "Two entries must fit in a cache line");
+
+    /**
+     * @brief Cache-line-sized block, to allocate images on a cache line boundary.
+     */
+    struct alignas(CacheLine) Line {
+        unsigned char bytes[CacheLine];
+    };
+
+    static std::uint64_t Mix(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Hash the bytes of a string eight at a time.
+     */
+    static std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t hash) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (; size >= 8; bytes += 8, size -= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 29;
+        }
+        if (size) {
+            // Overlapping fixed-size loads, so the tail does not need a variable-length copy.
+            std::uint64_t word;
+            if (size >= 4) {
+                std::uint32_t first, last;
+                std::memcpy(&first, bytes, 4);
+                std::memcpy(&last, bytes + size - 4, 4);
+                word = (static_cast<std::uint64_t>(first) << 32) | last;
+            }
+            else {
+                word = (static_cast<std::uint64_t>(bytes[0]) << 16) | (static_cast<std::uint64_t>(bytes[size >> 1]) << 8) | bytes[size - 1];
+            }
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 29;
+        }
+        return hash;
+    }
+
+    static std::uint64_t Hash(view_type section, view_type key) {
+        // The lengths are mixed in, so ("ab", "c") and ("a", "bc") hash differently.
+        std::uint64_t hash = HashBytes(section.data(), section.size() * sizeof(CharT), 0xCBF29CE484222325ull ^ section.size());
+        hash = HashBytes(key.data(), key.size() * sizeof(CharT), hash ^ (static_cast<std::uint64_t>(key.size()) << 32));
+        return Mix(hash);
+    }
+
+    /**
+     * @brief Map a 32-bit value to [0, range) without a division.
+     */
+    static std::uint32_t Reduce(std::uint32_t value, std::uint32_t range) {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(value) * range) >> 32);
+    }
+
+    static std::uint32_t BucketOf(std::uint64_t g, std::uint32_t buckets) {
+        return Reduce(static_cast<std::uint32_t>(g >> 32), buckets);
+    }
+
+    static std::uint32_t SlotOf(std::uint64_t g, std::uint32_t displacement, std::uint32_t slots) {
+        return Reduce(static_cast<std::uint32_t>(Mix(g + displacement)), slots);
+    }
+
+    std::uint32_t slot(std::uint64_t hash) const {
+        std::uint64_t g = Mix(hash ^ this->header->seed);
+        std::uint32_t displacement = this->displacements[BucketOf(g, this->header->bucketCount)];
+        return SlotOf(g, displacement, this->header->entryCount);
+    }
+
+    static std::uint64_t AlignUp(std::uint64_t offset, std::uint64_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Point the document at an image, after checking that every offset stays inside it.
+     */
+    bool attach(std::shared_ptr<const unsigned char> bytes, std::size_t size) {
+        if (size < sizeof(Header) || reinterpret_cast<std::uintptr_t>(bytes.get()) % CacheLine != 0) {
+            return false;
+        }
+
+        const Header* h = reinterpret_cast<const Header*>(bytes.get());
+        if (std::memcmp(h->magic, Magic, sizeof(Magic)) != 0 || h->charSize != sizeof(CharT) || h->imageSize > size ||
+            (h->entryCount == 0) != (h->bucketCount == 0) ||
+            h->entriesOffset % CacheLine != 0 || h->entriesOffset + std::uint64_t(h->entryCount) * sizeof(Entry) > h->imageSize ||
+            h->displacementsOffset % alignof(std::uint32_t) != 0 ||
+            h->displacementsOffset + std::uint64_t(h->bucketCount) * sizeof(std::uint32_t) > h->imageSize ||
+            h->slotsOffset % alignof(std::uint32_t) != 0 ||
+            h->slotsOffset + std::uint64_t(h->entryCount) * sizeof(std::uint32_t) > h->imageSize ||
+            h->poolOffset % alignof(CharT) != 0 || h->poolLength > (h->imageSize - std::min(h->poolOffset, h->imageSize)) / sizeof(CharT)) {
+            return false;
+        }
+
+        const Entry* e = reinterpret_cast<const Entry*>(bytes.get() + h->entriesOffset);
+        const std::uint32_t* s = reinterpret_cast<const std::uint32_t*>(bytes.get() + h->slotsOffset);
+        for (std::uint32_t i = 0; i < h->entryCount; ++i) {
+            if (s[i] >= h->entryCount ||
+                std::uint64_t(e[i].key) + e[i].sectionLength + e[i].keyLength > h->poolLength ||
+                std::uint64_t(e[i].value) + e[i].valueLength > h->poolLength) {
+                return false;
+            }
+        }
+
+        this->image = std::move(bytes);
+        this->header = h;
+        this->entries = e;
+        this->displacements = reinterpret_cast<const std::uint32_t*>(this->image.get() + h->displacementsOffset);
+        this->slots = s;
+        this->pool = reinterpret_cast<const CharT*>(this->image.get() + h->poolOffset);
+        return true;
+    }
+
+    template <typename Data, typename Count>
+    void build(const Data& data, Count count) {
+        struct Source {
+            std::uint64_t reads;
+            std::uint64_t hash;
+            const string_type* section;
+            const string_type* key;
+            const string_type* value;
+        };
+
+        std::vector<Source> sources;
+        std::uint64_t poolLength = 0;
+        for (const auto& section : data) {
+            for (const auto& pair : section.second) {
+                sources.push_back({ count(&pair.second), Hash(section.first, pair.first), &section.first, &pair.first, &pair.second });
+                poolLength += section.first.size() + pair.first.size() + pair.second.size();
+            }
+        }
+        if (sources.size() > UINT32_MAX || poolLength > UINT32_MAX) {
+            throw std::length_error("Too many keys to freeze");
+        }
+
+        // Hot entries first; ties keep the section and key order.
+        std::stable_sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) { return a.reads > b.reads; });
+
+        const std::uint32_t entryCount = static_cast<std::uint32_t>(sources.size());
+        const std::uint32_t bucketCount = sources.empty() ? 0 : static_cast<std::uint32_t>(std::max<std::size_t>(1, sources.size() / BucketLoad));
+
+        Header h = {};
+        std::memcpy(h.magic, Magic, sizeof(Magic));
+        h.charSize = sizeof(CharT);
+        h.entryCount = entryCount;
+        h.bucketCount = bucketCount;
+        h.entriesOffset = AlignUp(sizeof(Header), CacheLine);
+        h.displacementsOffset = h.entriesOffset + std::uint64_t(entryCount) * sizeof(Entry);
+        h.slotsOffset = h.displacementsOffset + std::uint64_t(bucketCount) * sizeof(std::uint32_t);
+        h.poolOffset = AlignUp(h.slotsOffset + std::uint64_t(entryCount) * sizeof(std::uint32_t), alignof(CharT));
+        h.poolLength = poolLength;
+        h.imageSize = h.poolOffset + poolLength * sizeof(CharT);
+
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(sources.size());
+        for (const Source& source : sources) {
+            hashes.push_back(source.hash);
+        }
+
+        std::vector<std::uint32_t> displacementTable, slotTable;
+        // A failed search only happens for unlucky seeds, so retry with another one.
+        for (h.seed = 0; !sources.empty() && !Place(hashes, h.seed, bucketCount, displacementTable, slotTable); ++h.seed) {
+            if (h.seed == 64) {
+                throw std::runtime_error("Failed to build a perfect hash; are there duplicate keys?");
+            }
+        }
+
+        std::size_t lines = static_cast<std::size_t>(AlignUp(h.imageSize, CacheLine) / CacheLine);
+        std::shared_ptr<Line[]> buffer(new Line[lines]());
+        unsigned char* bytes = buffer[0].bytes;
+
+        std::memcpy(bytes, &h, sizeof(h));
+        std::copy(displacementTable.begin(), displacementTable.end(), reinterpret_cast<std::uint32_t*>(bytes + h.displacementsOffset));
+        std::copy(slotTable.begin(), slotTable.end(), reinterpret_cast<std::uint32_t*>(bytes + h.slotsOffset));
+
+        Entry* entry = reinterpret_cast<Entry*>(bytes + h.entriesOffset);
+        CharT* text = reinterpret_cast<CharT*>(bytes + h.poolOffset);
+        std::uint32_t offset = 0;
+        auto append = [&](const string_type& str) {
+            std::copy(str.begin(), str.end(), text + offset);
+            offset += static_cast<std::uint32_t>(str.size());
+        };
+
+        for (const Source& source : sources) {
+            entry->hash = source.hash;
+            entry->key = offset;
+            entry->sectionLength = static_cast<std::uint32_t>(source.section->size());
+            entry->keyLength = static_cast<std::uint32_t>(source.key->size());
+            append(*source.section);
+            append(*source.key);
+            entry->value = offset;
+            entry->valueLength = static_cast<std::uint32_t>(source.value->size());
+            append(*source.value);
+            ++entry;
+        }
+
+        this->attach(std::shared_ptr<const unsigned char>(buffer, bytes), lines * CacheLine);
+    }
+
+    /**
+     * @brief Search the displacement of every bucket of the perfect hash for a seed.
+     *
+     * Buckets are placed from the largest to the smallest. For each, displacements are tried in
+     * order until every key of the bucket lands on a distinct free slot.
+     *
+     * @return True if every bucket was placed, false otherwise.
+     */
+    static bool Place(const std::vector<std::uint64_t>& hashes, std::uint64_t seed, std::uint32_t bucketCount,
+        std::vector<std::uint32_t>& displacementTable, std::vector<std::uint32_t>& slotTable) {
+        const std::uint32_t m = static_cast<std::uint32_t>(hashes.size());
+        const std::uint32_t maxDisplacement = 1u << 24;
+
+        displacementTable.assign(bucketCount, 0);
+        slotTable.assign(m, 0);
+
+        std::vector<std::vector<std::pair<std::uint64_t, std::uint32_t>>> buckets(bucketCount);
+        for (std::uint32_t i = 0; i < m; ++i) {
+            std::uint64_t g = Mix(hashes[i] ^ seed);
+            buckets[BucketOf(g, bucketCount)].push_back({ g, i });
+        }
+
+        std::vector<std::uint32_t> order(bucketCount);
+        for (std::uint32_t i = 0; i < bucketCount; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<bool> taken(m, false);
+        std::vector<std::uint32_t> candidate;
+
+        for (std::uint32_t bucketIndex : order) {
+            const auto& bucket = buckets[bucketIndex];
+            if (bucket.empty()) {
+                break;
+            }
+
+            std::uint32_t displacement = 0;
+            for (; displacement < maxDisplacement; ++displacement) {
+                candidate.clear();
+                for (const auto& key : bucket) {
+                    std::uint32_t slot = SlotOf(key.first, displacement, m);
+                    if (taken[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                        break;
+                    }
+                    candidate.push_back(slot);
+                }
+                if (candidate.size() == bucket.size()) {
+                    break;
+                }
+            }
+            if (displacement == maxDisplacement) {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < bucket.size(); ++i) {
+                taken[candidate[i]] = true;
+                slotTable[candidate[i]] = bucket[i].second;
+            }
+            displacementTable[bucketIndex] = displacement;
+        }
+        return true;
+    }
+
+    std::shared_ptr<const unsigned char> image;
+    const Header* header;
+    const Entry* entries;
+    const std::uint32_t* displacements;
+    const std::uint32_t* slots;
+    const CharT* pool;
+};
+
+/**
+ * @brief Access profile over an IniParserA.
+ */
+typedef IniBasicAccessProfile<IniParserA>   IniAccessProfileA;
+
+/**
+ * @brief Access profile over an IniParserW.
+ */
+typedef IniBasicAccessProfile<IniParserW>   IniAccessProfileW;
+
+/**
+ * @brief Frozen copy of an IniParserA.
+ */
+typedef IniBasicFrozen<char>                IniFrozenA;
+
+/**
+ * @brief Frozen copy of an IniParserW.
+ */
+typedef IniBasicFrozen<wchar_t>             IniFrozenW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the access profile type based on whether the _UNICODE macro is defined.
+ */
+# define IniAccessProfile   IniAccessProfileW
+
+/**
+ * @brief Macro that defines the frozen document type based on whether the _UNICODE macro is defined.
+ */
+# define IniFrozen          IniFrozenW
+
+#else
+
+/**
+ * @brief Macro that defines the access profile type based on whether the _UNICODE macro is defined.
+ */
+# define IniAccessProfile   IniAccessProfileA
+
+/**
+ * @brief Macro that defines the frozen document type based on whether the _UNICODE macro is defined.
+ */
+# define IniFrozen          IniFrozenA
+
+#endif
@@ -0,0 +1,464 @@
+#include "differential.hpp"
+
+#include <string>
+#include <vector>
+
+#include "reference.hpp"
+#include "xini/array.hpp"
+#include "xini/bulk.hpp"
+#include "xini/decimal.hpp"
+#include "xini/dict.hpp"
+#include "xini/parser.hpp"
+#include "xini/query.hpp"
+
+namespace {
+
+    // Bounds the number of lines and values checked as arrays, dictionaries and integers per input.
+    const std::size_t MaxValueChecks = 4096;
+
+    struct Report {
+        std::ostream& out;
+        std::size_t mismatches;
+
+        void fail(const char* check, std::string_view subject, const std::string& detail);
+    };
+
+    std::string Escape(std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+
+        std::string escaped = "\"";
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (c == '\n') {
+                escaped += "\\n";
+            }
+            else if (c == '\r') {
+                escaped += "\\r";
+            }
+            else if (c == '\t') {
+                escaped += "\\t";
+            }
+            else if (byte < 0x20 || byte >= 0x7F) {
+                escaped += "\\x";
+                escaped += hex[byte >> 4];
+                escaped += hex[byte & 0xF];
+            }
+            else {
+                escaped += c;
+            }
+        }
+        escaped += '"';
+        return escaped;
+    }
+
+    void Report::fail(const char* check, std::string_view subject, const std::string& detail) {
+        ++this->mismatches;
+        this->out << check << ": " << detail << "\n    on " << Escape(subject.substr(0, 256))
+                  << (subject.size() > 256 ? "..." : "") << '\n';
+    }
+
+    // Every byte becomes the wide character of the same value, so the wide paths see the same input.
+    template <typename CharT>
+    std::basic_string<CharT> Convert(std::string_view text) {
+        std::basic_string<CharT> converted;
+        converted.reserve(text.size());
+        for (char c : text) {
+            converted.push_back(static_cast<CharT>(static_cast<unsigned char>(c)));
+        }
+        return converted;
+    }
+
+    template <typename CharT>
+    std::string Narrow(std::basic_string_view<CharT> text) {
+        std::string narrowed;
+        narrowed.reserve(text.size());
+        for (CharT c : text) {
+            narrowed.push_back(static_cast<char>(c));
+        }
+        return narrowed;
+    }
+
+    // Compare a parsed document with the reference one. Without values, only the sections and keys are compared.
+    template <typename Parser>
+    bool SameDocument(const reference::Document& expected, const Parser& parser, bool values, std::string& difference) {
+        typedef typename Parser::char_type char_type;
+        const auto& actual = parser.view();
+
+        for (const auto& section : expected) {
+            auto sectionIt = actual.find(Convert<char_type>(section.first));
+            if (sectionIt == actual.end()) {
+                difference = "section " + Escape(section.first) + " is missing";
+                return false;
+            }
+            for (const auto& pair : section.second) {
+                auto keyIt = sectionIt->second.find(Convert<char_type>(pair.first));
+                if (keyIt == sectionIt->second.end()) {
+                    difference = "key " + Escape(pair.first) + " of section " + Escape(section.first) + " is missing";
+                    return false;
+                }
+                if (values && keyIt->second != Convert<char_type>(pair.second)) {
+                    difference = "key " + Escape(pair.first) + " of section " + Escape(section.first) + " is "
+                        + Escape(Narrow<char_type>(keyIt->second)) + " instead of " + Escape(pair.second);
+                    return false;
+                }
+            }
+            if (sectionIt->second.size() != section.second.size()) {
+                difference = "section " + Escape(section.first) + " has " + std::to_string(sectionIt->second.size())
+                    + " keys instead of " + std::to_string(section.second.size());
+                return false;
+            }
+        }
+        if (actual.size() != expected.size()) {
+            difference = std::to_string(actual.size()) + " sections instead of " + std::to_string(expected.size());
+            return false;
+        }
+        return true;
+    }
+
+    template <typename Parser>
+    void CompareDocument(Report& report, const char* check, std::string_view input, const reference::Document& expected,
+        const Parser& parser, bool values = true) {
+        std::string difference;
+        if (!SameDocument(expected, parser, values, difference)) {
+            report.fail(check, input, difference);
+        }
+    }
+
+    void CheckDocument(Report& report, std::string_view input, std::vector<std::string>& values) {
+        // operator<< takes a NUL-terminated string, so it sees the input up to its first NUL. feed() sees all of it.
+        const std::string content(input);
+        const std::string terminated(input.substr(0, input.find('\0')));
+
+        const reference::Document whole = reference::parse_raw(content);
+        const reference::Document expected = terminated.size() == content.size() ? whole : reference::parse_raw(terminated);
+
+        {
+            IniParserA ini;
+            ini << terminated.c_str();
+            CompareDocument(report, "IniParserA::operator<<", input, expected, ini);
+        }
+        {
+            IniParserW ini;
+            ini << Convert<wchar_t>(terminated).c_str();
+            CompareDocument(report, "IniParserW::operator<<", input, expected, ini);
+        }
+        {
+            // The chunk lengths come from the input, so the fuzzer also explores where the lines are cut.
+            IniParserA ini;
+            for (std::size_t offset = 0; offset < content.size();) {
+                std::size_t length = 1 + static_cast<unsigned char>(content[offset]) % 64;
+                if (length > content.size() - offset) {
+                    length = content.size() - offset;
+                }
+                ini.feed(content.data() + offset, length);
+                offset += length;
+            }
+            ini.finish();
+            CompareDocument(report, "IniParserA::feed", input, whole, ini);
+        }
+        {
+            IniParserA ini;
+            IniDiagnosticsA diagnostics;
+            ini.load_string(terminated.c_str(), diagnostics);
+            CompareDocument(report, "IniParserA::load_string", input, expected, ini);
+
+            for (const auto& section : expected) {
+                for (const auto& pair : section.second) {
+                    if (diagnostics.position(section.first, pair.first).line == 0) {
+                        report.fail("IniDiagnosticsA::position", input, "key " + Escape(pair.first) + " of section "
+                            + Escape(section.first) + " has no position");
+                    }
+                }
+            }
+        }
+        {
+            IniDialect keepAll;
+            keepAll.duplicates = IniDuplicateKeepAll;
+            IniParserA all(keepAll);
+            all << terminated.c_str();
+            CompareDocument(report, "IniParserA::operator<< (IniDuplicateKeepAll)", input, expected, all);
+
+            IniDialect firstWins;
+            firstWins.duplicates = IniDuplicateFirstWins;
+            IniParserA first(firstWins);
+            first << terminated.c_str();
+            CompareDocument(report, "IniParserA::operator<< (IniDuplicateFirstWins)", input, expected, first, false);
+
+            for (const auto& section : expected) {
+                for (const auto& pair : section.second) {
+                    auto kept = all.values(section.first, pair.first);
+                    auto single = first.values(section.first, pair.first);
+                    if (kept.empty() || kept[kept.size() - 1] != pair.second || single.size() != 1 || single[0] != kept[0]) {
+                        report.fail("IniParserA::values", input, "the values of key " + Escape(pair.first) + " of section "
+                            + Escape(section.first) + " do not match the first and last value");
+                    }
+                }
+            }
+        }
+
+        for (std::size_t begin = 0; begin <= content.size() && values.size() < MaxValueChecks;) {
+            std::size_t end = content.find('\n', begin);
+            if (end == std::string::npos) {
+                end = content.size();
+            }
+            values.push_back(content.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        for (const auto& section : whole) {
+            for (const auto& pair : section.second) {
+                if (values.size() < MaxValueChecks) {
+                    values.push_back(pair.second);
+                }
+            }
+        }
+    }
+
+    // The syntax the baseline integer parser was written for: a decimal number, or digits after "0x" or "0b".
+    // The library also accepts blanks, '+', signed and upper-case prefixes, "0o" and digit separators,
+    // and rejects trailing garbage that std::stol ignored.
+    bool IsBaselineInteger(std::string_view text) {
+        const char* digits = "0123456789";
+        if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'b')) {
+            digits = text[1] == 'x' ? "0123456789abcdefABCDEF" : "01";
+            text.remove_prefix(2);
+        }
+        else if (!text.empty() && text[0] == '-') {
+            text.remove_prefix(1);
+        }
+        return !text.empty() && text.find_first_not_of(digits) == std::string_view::npos;
+    }
+
+    void CheckInteger(Report& report, std::string_view text) {
+        long value = 0;
+        IniParseStatus status = IniParseInt64Chars(text.data(), text.data() + text.size(), value);
+
+        const std::wstring wide = Convert<wchar_t>(text);
+        long wideValue = 0;
+        IniParseStatus wideStatus = IniParseInt64Chars(wide.data(), wide.data() + wide.size(), wideValue);
+        if (wideStatus != status || (status == IniParseOk && wideValue != value)) {
+            report.fail("IniParseInt64Chars<wchar_t>", text, "differs from IniParseInt64Chars<char>");
+        }
+
+        if (status == IniParseOk) {
+            for (const IniString& formatted : { Int64ToHexString(value), Int64ToBinaryString(value) }) {
+                long parsed = 0;
+                if (IniParseInt64Chars(formatted.data(), formatted.data() + formatted.size(), parsed) != IniParseOk || parsed != value) {
+                    report.fail("IniParseInt64Chars", text, "does not read back " + Escape(Narrow<IniChar>(formatted)));
+                }
+            }
+        }
+
+        if (!IsBaselineInteger(text)) {
+            return;
+        }
+
+        // The baseline throws for out-of-range numbers and for invalid ones alike, so only acceptance is compared.
+        long expected = 0;
+        bool accepted = true;
+        try {
+            expected = reference::IniParseInt64(std::string(text));
+        }
+        catch (...) {
+            accepted = false;
+        }
+
+        // Prefixed numbers beyond LONG_MAX are read as two's complement, where std::stol reported an overflow.
+        bool twosComplement = !accepted && text[0] == '0' && status == IniParseOk && value < 0;
+
+        if (accepted ? status != IniParseOk || value != expected : status == IniParseOk && !twosComplement) {
+            report.fail("IniParseInt64Chars", text, (status == IniParseOk ? "returns " + std::to_string(value)
+                : "rejects it with status " + std::to_string(status)) + " where the reference "
+                + (accepted ? "returns " + std::to_string(expected) : std::string("rejects it")));
+        }
+    }
+
+    // The arrays the baseline splitter and IniDecodeInt64Array agree on: "[...]" around elements that
+    // contain no ']', only spaces as blanks, and at least one non-blank character.
+    bool IsBaselineArray(std::string_view text) {
+        std::size_t first = text.find_first_not_of(' ');
+        std::size_t last = text.find_last_not_of(' ');
+        if (first == std::string_view::npos || last - first < 2 || text[first] != '[' || text[last] != ']') {
+            return false;
+        }
+        std::string_view inner = text.substr(first + 1, last - first - 1);
+        return inner.find_first_of("]\t\r\n") == std::string_view::npos && inner.find_first_not_of(' ') != std::string_view::npos;
+    }
+
+    void CheckArray(Report& report, std::string_view text) {
+        const std::string input(text);
+        const std::vector<std::string> expected = reference::parseArrayA(input);
+
+        if (parseArrayA(input) != expected) {
+            report.fail("parseArrayA", text, "differs from the reference");
+        }
+
+        std::vector<std::wstring> wide = parseArrayW(Convert<wchar_t>(text));
+        bool sameWide = wide.size() == expected.size();
+        for (std::size_t i = 0; sameWide && i < wide.size(); ++i) {
+            sameWide = wide[i] == Convert<wchar_t>(expected[i]);
+        }
+        if (!sameWide) {
+            report.fail("parseArrayW", text, "differs from the reference");
+        }
+
+        std::vector<long> decoded;
+        std::vector<std::size_t> failures;
+        IniDecodeInt64Array(Convert<IniChar>(text), decoded, &failures);
+
+        if (!IsBaselineArray(text)) {
+            return;
+        }
+        if (decoded.size() != expected.size()) {
+            report.fail("IniDecodeInt64Array", text, std::to_string(decoded.size()) + " elements instead of "
+                + std::to_string(expected.size()));
+            return;
+        }
+
+        std::size_t failure = 0;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            long value = 0;
+            bool parsed = IniParseInt64Chars(expected[i].data(), expected[i].data() + expected[i].size(), value) == IniParseOk;
+            bool failed = failure < failures.size() && failures[failure] == i;
+            failure += failed;
+
+            if (failed == parsed || decoded[i] != (parsed ? value : 0)) {
+                report.fail("IniDecodeInt64Array", text, "element " + std::to_string(i) + " differs from "
+                    + Escape(expected[i]) + " read alone");
+            }
+            CheckInteger(report, expected[i]);
+        }
+        if (failure != failures.size()) {
+            report.fail("IniDecodeInt64Array", text, "reports failures out of order");
+        }
+    }
+
+    // The dictionaries both scanners read the same way: "{key: value; ...}" with a ':' in every entry, only
+    // spaces as blanks, no space before the closing brace, and none of the characters the scanner of the
+    // library gives a meaning to (quotes, brackets, braces and ',') inside.
+    bool IsBaselineDictionary(std::string_view text) {
+        std::size_t first = text.find_first_not_of(' ');
+        std::size_t last = text.find_last_not_of(' ');
+        if (first == std::string_view::npos || last - first < 2 || text[first] != '{' || text[last] != '}' || text[last - 1] == ' ') {
+            return false;
+        }
+        std::string_view inner = text.substr(first + 1, last - first - 1);
+        if (inner.find_first_of(std::string_view("\"'[]{},\t\r\n\0", 12)) != std::string_view::npos) {
+            return false;
+        }
+        for (std::size_t begin = 0;;) {
+            std::size_t end = inner.find(';', begin);
+            std::string_view entry = inner.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+            if (entry.find(':') == std::string_view::npos) {
+                return false;
+            }
+            if (end == std::string_view::npos) {
+                return true;
+            }
+            begin = end + 1;
+        }
+    }
+
+    void CheckDictionary(Report& report, std::string_view text) {
+        const std::string input(text);
+        std::map<std::string, std::string> dictionary = parseDictionaryA(input);
+        std::map<std::wstring, std::wstring> wide = parseDictionaryW(Convert<wchar_t>(text));
+
+        bool sameWide = wide.size() == dictionary.size();
+        for (const auto& entry : dictionary) {
+            auto it = wide.find(Convert<wchar_t>(entry.first));
+            sameWide = sameWide && it != wide.end() && it->second == Convert<wchar_t>(entry.second);
+        }
+        if (!sameWide) {
+            report.fail("parseDictionaryW", text, "differs from parseDictionaryA");
+        }
+
+        if (!IsBaselineDictionary(text)) {
+            return;
+        }
+        if (dictionary != reference::parseDictionaryA(input)) {
+            report.fail("parseDictionaryA", text, "differs from the reference");
+        }
+        if (parseDictionaryA(dictionaryToStringA(dictionary)) != dictionary) {
+            report.fail("dictionaryToStringA", text, "is not read back by parseDictionaryA");
+        }
+    }
+
+    // The definition of a glob match, by recursion on the pattern: '*' matches any run of characters, '?' any
+    // one character, and every other character itself, even '*' or '?' in the text.
+    bool GlobReference(std::string_view pattern, std::string_view text) {
+        if (pattern.empty()) {
+            return text.empty();
+        }
+        if (pattern[0] == '*') {
+            for (std::size_t skip = 0; skip <= text.size(); ++skip) {
+                if (GlobReference(pattern.substr(1), text.substr(skip))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        return !text.empty() && (pattern[0] == '?' || pattern[0] == text[0]) && GlobReference(pattern.substr(1), text.substr(1));
+    }
+
+    // Bounds the length of the values used as glob patterns, since the reference is exponential in the number of '*'.
+    const std::size_t MaxGlobLength = 24;
+
+    // The patterns are derived from the value: its prefixes and suffixes around a '*', and the value with one
+    // character turned into a wildcard. Each one is matched against the value and against the value without
+    // one of its characters, so that both matches and misses are compared.
+    void CheckGlob(Report& report, std::string_view text) {
+        if (text.size() > MaxGlobLength) {
+            return;
+        }
+
+        std::vector<std::string> patterns = { std::string(text), "*" };
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            patterns.push_back(std::string(text.substr(0, i)) + '*');
+            patterns.push_back('*' + std::string(text.substr(i + 1)));
+            patterns.push_back(std::string(text.substr(0, i)) + '*' + std::string(text.substr(i)));
+            for (char wildcard : { '*', '?' }) {
+                std::string pattern(text);
+                pattern[i] = wildcard;
+                patterns.push_back(pattern);
+            }
+        }
+
+        std::vector<std::string> texts = { std::string(text) };
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            texts.push_back(std::string(text.substr(0, i)) + std::string(text.substr(i + 1)));
+        }
+
+        for (const std::string& pattern : patterns) {
+            for (const std::string& subject : texts) {
+                bool expected = GlobReference(pattern, subject);
+                if (IniGlobMatch<char>(pattern, subject) != expected) {
+                    report.fail("IniGlobMatch", subject, "pattern " + Escape(pattern) + (expected ? " does not match" : " matches"));
+                }
+                if (IniGlobMatch<wchar_t>(Convert<wchar_t>(pattern), Convert<wchar_t>(subject)) != expected) {
+                    report.fail("IniGlobMatch<wchar_t>", subject, "pattern " + Escape(pattern) + (expected ? " does not match" : " matches"));
+                }
+            }
+        }
+    }
+
+}
+
+std::size_t IniDifferentialCheck(std::string_view input, std::ostream& out) {
+    Report report = { out, 0 };
+    std::vector<std::string> values;
+
+    CheckDocument(report, input, values);
+
+    for (const std::string& value : values) {
+        CheckArray(report, value);
+        CheckDictionary(report, value);
+        CheckInteger(report, value);
+        CheckGlob(report, value);
+    }
+
+    return report.mismatches;
+}
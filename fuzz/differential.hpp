@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+
+/**
+ * @brief Compare the library with the baseline implementations of reference.hpp on one input.
+ *
+ * The input is parsed as an INI document by the reference parser and by IniParserA and IniParserW,
+ * through operator<<, feed() in chunks, the diagnostic parse and the duplicate-key policies. Every
+ * line and every value of the document is then checked as an array, a dictionary and an integer,
+ * and the short ones are matched by IniGlobMatch against glob patterns derived from them.
+ *
+ * The parser and the array splitter must match the reference on any input. The dictionary scanner
+ * and the integer parser accept a larger syntax than the baseline, so they are compared on the
+ * inputs the baseline was written for (see differential.cpp), and only run under the sanitizers
+ * on the others. IniGlobMatch is compared with the recursive definition of a glob match.
+ *
+ * @param input The input. It may contain any byte, including NUL.
+ * @param out The stream receiving a description of every mismatch.
+ * @return The number of mismatches.
+ */
+std::size_t IniDifferentialCheck(std::string_view input, std::ostream& out);
@@ -0,0 +1,17 @@
+// libFuzzer entry point. Any mismatch with the reference implementations aborts, so the engine keeps
+// the input as a crash. Built as the xini_fuzz target with -DXINI_FUZZ_LIBFUZZER=ON and Clang, or with
+// afl-clang-fast++ for AFL++, which runs LLVMFuzzerTestOneInput as well.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "differential.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    std::string_view input(reinterpret_cast<const char*>(data), size);
+
+    if (IniDifferentialCheck(input, std::cerr) != 0) {
+        std::abort();
+    }
+    return 0;
+}
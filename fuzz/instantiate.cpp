@@ -0,0 +1,31 @@
+// Explicit instantiations of the class templates of the library, in both character widths.
+//
+// The templates are only compiled where they are used, and the benchmarks use few of them, so
+// this translation unit is what makes the build of the fuzz project fail when one of the headers
+// no longer compiles.
+
+#include "xini/frozen.hpp"
+#include "xini/include.hpp"
+#include "xini/interpolate.hpp"
+#include "xini/journal.hpp"
+#include "xini/layered.hpp"
+#include "xini/query.hpp"
+#include "xini/transaction.hpp"
+
+template class IniBasicLayered<IniParserA>;
+template class IniBasicLayered<IniParserW>;
+template class IniBasicTransaction<IniParserA>;
+template class IniBasicTransaction<IniParserW>;
+template class IniBasicJournal<IniParserA>;
+template class IniBasicJournal<IniParserW>;
+template class IniBasicIncludeCache<IniParserA>;
+template class IniBasicIncludeCache<IniParserW>;
+template class IniBasicInterpolated<IniParserA>;
+template class IniBasicInterpolated<IniParserW>;
+template class IniBasicAccessProfile<IniParserA>;
+template class IniBasicAccessProfile<IniParserW>;
+template class IniBasicFrozen<char>;
+template class IniBasicFrozen<wchar_t>;
+
+template bool IniGlobMatch<char>(std::string_view, std::string_view);
+template bool IniGlobMatch<wchar_t>(std::wstring_view, std::wstring_view);
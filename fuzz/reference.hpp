@@ -0,0 +1,169 @@
+// The baseline implementations of the parse paths that have fast replacements in the library,
+// kept verbatim as the reference of the differential checks. Only the containers are spelled out:
+// the parser's data member becomes a Document argument, and IniString becomes std::string.
+
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace reference {
+
+    typedef std::map<std::string, std::map<std::string, std::string>> Document;
+
+    // IniParserA::parse_line
+    static bool parse_line(Document& data, std::string* currentSection, const std::string& line) {
+        if (line.empty() || line[0] == ';') return false;
+        if (line[0] == '[' && line.back() == ']') {
+            *currentSection = line.substr(1, line.size() - 2);
+            return false;
+        }
+
+        size_t equalPos = line.find('=');
+        if (equalPos == std::string::npos) return false;
+
+        std::string key = line.substr(0, equalPos);
+        std::string value = line.substr(equalPos + 1);
+        data[*currentSection][key] = value;
+        return true;
+    }
+
+    // IniParserA::parse_raw
+    static Document parse_raw(const std::string& content) {
+        Document data;
+        std::istringstream stringStream(content);
+
+        std::string line;
+        std::string currentSection;
+        while (std::getline(stringStream, line)) {
+            if (!parse_line(data, &currentSection, line)) {
+                continue;
+            }
+        }
+        return data;
+    }
+
+    static std::vector<std::string> parseArrayA(const std::string& input) {
+        std::vector<std::string> result;
+        std::stringstream ss(input);
+        char delimiter;
+        ss >> delimiter;
+
+        std::string temp;
+        while (std::getline(ss, temp, ',')) {
+            temp.erase(0, temp.find_first_not_of(" "));
+            temp.erase(temp.find_last_not_of(" ") + 1);
+            if (!temp.empty() && temp.back() == ']') {
+                temp.pop_back();
+            }
+            result.push_back(temp);
+        }
+
+        return result;
+    }
+
+    static std::map<std::string, std::string> parseDictionaryA(const std::string& input)
+    {
+        std::map<std::string, std::string> result;
+        std::stringstream ss(input);
+        char delimiter;
+
+        ss >> delimiter;
+
+        std::string token;
+        while (std::getline(ss, token, ';')) {
+            std::string key, value;
+
+            std::size_t pos = token.find(':');
+
+            key = token.substr(0, pos);
+            value = token.substr(pos + 1);
+
+            key.erase(0, key.find_first_not_of(" "));
+            key.erase(key.find_last_not_of(" ") + 1);
+            value.erase(0, value.find_first_not_of(" "));
+            value.erase(value.find_last_not_of(" ") + 1);
+
+            if (!value.empty() && value.back() == '}') {
+                value.pop_back();
+            }
+
+            result[key] = value;
+        }
+
+        return result;
+    }
+
+    static long ParseDecimalBasedString(const std::string& str, int base)
+    {
+        return std::stol(str, nullptr, base);
+    }
+
+    static long ParseHexString(const std::string& hexStr)
+    {
+        size_t pos = 0x000;
+        if (hexStr.find("0x") == 0x000)
+        {
+            pos = 0x002;
+        }
+        return ParseDecimalBasedString(hexStr.substr(pos), 0x10);
+    }
+
+    static long ParseBinaryString(const std::string& binStr)
+    {
+        size_t pos = 0b0;
+        if (binStr.find("0b") == 0b0)
+        {
+            pos = 0b10;
+        }
+
+        return ParseDecimalBasedString(binStr.substr(pos), 0b10);
+    }
+
+    static bool IsHexString(const std::string& str)
+    {
+        return str.find("0x") == 0;
+    }
+
+    static bool IsBinaryString(const std::string& str)
+    {
+        return str.find("0b") == 0;
+    }
+
+    static bool IsDecimalString(const std::string& str)
+    {
+        try
+        {
+            ParseDecimalBasedString(str, 0xA);
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    static long IniParseInt64(const std::string& str)
+    {
+        if (!IsDecimalString(str))
+        {
+            throw std::runtime_error("Value cannot be a decimal type");
+        }
+
+        if (IsBinaryString(str))
+        {
+            return ParseBinaryString(str);
+        }
+
+        else if (IsHexString(str))
+        {
+            return ParseHexString(str);
+        }
+
+        return ParseDecimalBasedString(str, 0xA);
+    }
+
+}
@@ -0,0 +1,165 @@
+// Differential runner: checks the library against the reference implementations on a corpus and on
+// generated inputs, without a fuzzing engine.
+//
+//   xini_differential [--random N] [--seed N] [--lines N] [PATH...]
+//
+// Every PATH is a file, or a directory whose files are all checked (the seed corpus of the fuzzer,
+// or the crashes it saved). --random adds N documents of up to --lines lines assembled from the
+// fragments that break hand-written parsers: unterminated sections, stray '\r', NULs, repeated
+// keys, nested brackets and integers at the edges of their range. The exit status is 1 if any
+// input differs.
+//
+// Built by the CMake project of this directory:
+//
+//   cmake -S fuzz -B build-fuzz && cmake --build build-fuzz && ./build-fuzz/xini_differential fuzz/corpus --random 10000
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "differential.hpp"
+
+struct Options {
+    std::size_t random = 0;
+    unsigned long long seed = 1;
+    std::size_t lines = 32;
+    std::vector<std::filesystem::path> paths;
+};
+
+static Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--random") {
+            options.random = std::strtoul(value(), nullptr, 10);
+        }
+        else if (arg == "--seed") {
+            options.seed = std::strtoull(value(), nullptr, 10);
+        }
+        else if (arg == "--lines") {
+            options.lines = std::strtoul(value(), nullptr, 10);
+        }
+        else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Unknown option " << arg << std::endl;
+            std::exit(2);
+        }
+        else {
+            options.paths.push_back(arg);
+        }
+    }
+    return options;
+}
+
+static std::string GenerateDocument(std::mt19937_64& random, std::size_t maxLines)
+{
+    static const std::vector<std::string> fragments = {
+        "", " ", "\t", "\r", std::string(1, '\0'), "\xEF\xBB\xBF", "\xC3\xA9", "\xFF",
+        "[", "]", "[]", "[[a]]", "[a", "a]", "[ a ]", "=", "==", ";", "#", ":", ",", "{", "}", "\"", "'",
+        "key", "Key", "k e y", "section", "value", "a=b", "=value", "key=",
+        "0", "-0", "007", "-1", "42", "0x", "0b", "0o17", "0x1F", "0XFF", "0b101", "0B11", "1_000", "_1", "1_",
+        "+5", "-0x10", "12abc", " 13 ", "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+        "-9223372036854775809", "0x7FFFFFFFFFFFFFFF", "0x8000000000000000", "0xFFFFFFFFFFFFFFFF", "0x10000000000000000",
+        "0b1111111111111111111111111111111111111111111111111111111111111111", "99999999999999999999999",
+        "[1, 2, 3]", "[0x10,0b11 , -7]", "[1,,2]", "[ ]", "[1, [2], 3]", "[1, 2",
+        "{a: 1; b: 2}", "{a: 1, b: 2}", "{a:1;a:2}", "{k: v: w}", "{ key : value }", "{\"q;\": 'x'}", "{a: {b: 1}}", "{}", "{;}",
+    };
+
+    std::uniform_int_distribution<std::size_t> pick(0, fragments.size() - 1);
+    std::uniform_int_distribution<std::size_t> count(0, 4);
+    std::uniform_int_distribution<std::size_t> lines(0, maxLines);
+    std::uniform_int_distribution<int> shape(0, 9);
+
+    std::string document;
+    for (std::size_t line = lines(random); line > 0; --line) {
+        switch (shape(random)) {
+        case 0:
+            document += "[" + fragments[pick(random)] + "]";
+            break;
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+            document += fragments[pick(random)] + "=" + fragments[pick(random)];
+            break;
+        case 5:
+            document += std::string(static_cast<std::size_t>(random() % 512), "a=[; \r"[random() % 6]);
+            break;
+        default:
+            for (std::size_t n = count(random); n > 0; --n) {
+                document += fragments[pick(random)];
+            }
+            break;
+        }
+        if (random() % 16 != 0) {
+            document += random() % 8 == 0 ? "\r\n" : "\n";
+        }
+    }
+    return document;
+}
+
+static bool Check(const std::string& name, const std::string& input)
+{
+    std::ostringstream mismatches;
+    if (IniDifferentialCheck(input, mismatches) == 0) {
+        return true;
+    }
+    std::cerr << name << ":\n" << mismatches.str();
+    return false;
+}
+
+int main(int argc, char** argv) {
+
+    const Options options = ParseOptions(argc, argv);
+
+    std::vector<std::filesystem::path> files;
+    for (const auto& path : options.paths) {
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file()) {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        else {
+            files.push_back(path);
+        }
+    }
+
+    std::size_t checked = 0;
+    std::size_t failed = 0;
+
+    for (const auto& file : files) {
+        std::ifstream stream(file, std::ios::binary);
+        if (!stream.is_open()) {
+            std::cerr << "Cannot open " << file.string() << std::endl;
+            return 2;
+        }
+        std::string input((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        failed += !Check(file.string(), input);
+        ++checked;
+    }
+
+    std::mt19937_64 random(options.seed);
+    for (std::size_t i = 0; i < options.random; ++i) {
+        std::string input = GenerateDocument(random, options.lines);
+        failed += !Check("random document " + std::to_string(i) + " of seed " + std::to_string(options.seed), input);
+        ++checked;
+    }
+
+    std::cout << checked << " inputs checked, " << failed << " with mismatches" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
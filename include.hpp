@@ -0,0 +1,417 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <cstdint>
+#include                    <string>
+#include                    <string_view>
+#include                    <vector>
+#include                    <map>
+#include                    <memory>
+#include                    <mutex>
+#include                    <atomic>
+#include                    <thread>
+#include                    <future>
+#include                    <fstream>
+#include                    <filesystem>
+#include                    <algorithm>
+#include                    <stdexcept>
+
+#if !defined(_WIN32)
+#include                    <sys/stat.h>
+#endif
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+#pragma region              helpers
+
+/**
+ * @brief Identity and version of a file, used to tell whether a cached parse is still valid.
+ */
+struct IniFileStamp {
+    std::filesystem::file_time_type modified;
+    std::uintmax_t size = 0;
+    std::uint64_t device = 0;
+    std::uint64_t inode = 0;
+
+    bool operator==(const IniFileStamp& other) const {
+        return this->modified == other.modified && this->size == other.size &&
+            this->device == other.device && this->inode == other.inode;
+    }
+
+    bool operator!=(const IniFileStamp& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Get the stamp of a file.
+ *
+ * On Windows, the device and inode are left at 0 and the file is identified by its canonical path.
+ *
+ * @param path The path of the file.
+ * @param stamp Receives the stamp.
+ * @return True on success, false if the file does not exist or cannot be accessed.
+ */
+inline bool IniFileStampOf(const std::filesystem::path& path, IniFileStamp& stamp) {
+    std::error_code error;
+    stamp.modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    stamp.size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+#if !defined(_WIN32)
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    stamp.device = static_cast<std::uint64_t>(info.st_dev);
+    stamp.inode = static_cast<std::uint64_t>(info.st_ino);
+#endif
+    return true;
+}
+
+#pragma endregion
+
+/**
+ * @brief Process-wide cache of parsed INI files with include directives.
+ *
+ * A file can include other files, relative to its own directory, with a line
+ *
+ *     [include base.ini]
+ *
+ * anywhere in the file, or with "include = base.ini" before its first section. The included files
+ * are merged first, in the order of the directives, and the keys of the including file win. A directive
+ * does not change the current section of the including file.
+ *
+ * Each file is parsed once and shared, immutable, between every load that includes it: a base file used
+ * by 500 configurations is parsed once. Entries are keyed by canonical path and checked against the
+ * modification time, size and inode of the file on every load, so an edited file is parsed again.
+ * Independent files that are not cached yet are parsed in parallel.
+ *
+ * The cache is thread-safe.
+ */
+template <typename Parser>
+class IniBasicIncludeCache {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+    typedef std::basic_string_view<char_type>       view_type;
+
+    /**
+     * @brief The content of one file, without its includes.
+     */
+    struct Document {
+        Parser content;                                 ///< The keys of the file itself.
+        std::vector<std::filesystem::path> includes;    ///< The canonical paths of its includes, in order.
+    };
+
+    /**
+     * @brief Default constructor. Creates an empty cache, independent of shared().
+     */
+    IniBasicIncludeCache() {}
+
+    IniBasicIncludeCache(const IniBasicIncludeCache&) = delete;
+    IniBasicIncludeCache& operator=(const IniBasicIncludeCache&) = delete;
+
+    /**
+     * @brief Get the cache shared by the whole process.
+     *
+     * @return The shared cache.
+     */
+    static IniBasicIncludeCache& shared() {
+        static IniBasicIncludeCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Load an INI file and the files it includes into a parser.
+     *
+     * The keys are merged into the parser, and win over the keys it already has.
+     *
+     * @param ini The parser to load into.
+     * @param filename The name of the INI file.
+     * @return True if the file was successfully parsed, false if it could not be opened.
+     * @throws std::runtime_error If an included file cannot be opened, or if a file includes itself,
+     *         directly or not. The parser is left unchanged.
+     */
+    bool load(Parser& ini, const std::filesystem::path& filename) {
+        std::error_code error;
+        std::filesystem::path root = std::filesystem::canonical(filename, error);
+        if (error) {
+            return false;
+        }
+
+        std::map<std::filesystem::path, std::shared_ptr<const Document>> documents;
+        std::vector<std::filesystem::path> frontier(1, root);
+        while (!frontier.empty()) {
+            std::vector<std::shared_ptr<const Document>> fetched = this->fetch_all(frontier);
+
+            std::vector<std::filesystem::path> next;
+            for (std::size_t i = 0; i < frontier.size(); ++i) {
+                if (!fetched[i]) {
+                    if (frontier[i] == root) {
+                        return false;
+                    }
+                    throw std::runtime_error("Cannot open an included INI file");
+                }
+
+                documents.emplace(frontier[i], fetched[i]);
+                for (const auto& include : fetched[i]->includes) {
+                    if (documents.find(include) == documents.end() && std::find(next.begin(), next.end(), include) == next.end() &&
+                        std::find(frontier.begin(), frontier.end(), include) == frontier.end()) {
+                        next.push_back(include);
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+
+        Parser merged;
+        std::vector<std::filesystem::path> stack;
+        this->merge_into(merged, root, documents, stack);
+        ini.merge(std::move(merged));
+        return true;
+    }
+
+    /**
+     * @brief Get the cached content of one file, parsing it if needed.
+     *
+     * @param filename The name of the INI file.
+     * @return The content of the file without its includes, or nullptr if it could not be opened.
+     */
+    std::shared_ptr<const Document> document(const std::filesystem::path& filename) {
+        std::error_code error;
+        std::filesystem::path path = std::filesystem::canonical(filename, error);
+        if (error) {
+            return nullptr;
+        }
+        return this->fetch(path);
+    }
+
+    /**
+     * @brief Get the number of cached files.
+     *
+     * @return The number of cached files.
+     */
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->entries.size();
+    }
+
+    /**
+     * @brief Drop every cached file.
+     *
+     * Documents still referenced by a caller stay valid.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->entries.clear();
+    }
+
+private:
+    struct Entry {
+        IniFileStamp stamp;
+        std::shared_ptr<const Document> document;
+    };
+
+    /**
+     * @brief Fetch several files, parsing the ones missing from the cache in parallel.
+     *
+     * At most one thread per hardware thread parses, the calling thread included; each one takes the
+     * next missing file until none is left.
+     */
+    std::vector<std::shared_ptr<const Document>> fetch_all(const std::vector<std::filesystem::path>& paths) {
+        std::vector<std::shared_ptr<const Document>> fetched(paths.size());
+        std::vector<IniFileStamp> stamps(paths.size());
+        std::vector<std::size_t> missing;
+
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            if (!IniFileStampOf(paths[i], stamps[i])) {
+                continue;
+            }
+            fetched[i] = this->cached(paths[i], stamps[i]);
+            if (!fetched[i]) {
+                missing.push_back(i);
+            }
+        }
+
+        std::atomic<std::size_t> next(0);
+        auto work = [&]() {
+            for (std::size_t n; (n = next.fetch_add(1, std::memory_order_relaxed)) < missing.size();) {
+                std::size_t i = missing[n];
+                fetched[i] = this->parse(paths[i], stamps[i]);
+            }
+        };
+
+        unsigned hardware = std::thread::hardware_concurrency();
+        std::size_t workers = std::min<std::size_t>(missing.size(), hardware ? hardware : 1);
+
+        // Declared last, so that if work() throws, the helpers are joined before what they use is destroyed.
+        std::vector<std::future<void>> helpers;
+        for (std::size_t w = 1; w < workers; ++w) {
+            helpers.push_back(std::async(std::launch::async, work));
+        }
+        work();
+        for (auto& helper : helpers) {
+            helper.get();
+        }
+        return fetched;
+    }
+
+    /**
+     * @brief Fetch one file, parsing it if it is missing from the cache.
+     */
+    std::shared_ptr<const Document> fetch(const std::filesystem::path& path) {
+        IniFileStamp stamp;
+        if (!IniFileStampOf(path, stamp)) {
+            return nullptr;
+        }
+        std::shared_ptr<const Document> document = this->cached(path, stamp);
+        return document ? document : this->parse(path, stamp);
+    }
+
+    /**
+     * @brief Get a cached file if it has not changed since it was parsed.
+     */
+    std::shared_ptr<const Document> cached(const std::filesystem::path& path, const IniFileStamp& stamp) const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = this->entries.find(path);
+        if (it == this->entries.end() || it->second.stamp != stamp) {
+            return nullptr;
+        }
+        return it->second.document;
+    }
+
+    /**
+     * @brief Parse a file, splitting out its include directives, and cache it.
+     */
+    std::shared_ptr<const Document> parse(const std::filesystem::path& path, const IniFileStamp& stamp) {
+        std::basic_ifstream<char_type> file(path);
+        if (!file.is_open()) {
+            return nullptr;
+        }
+
+        auto document = std::make_shared<Document>();
+        string_type content;
+        string_type line;
+        bool inSection = false;
+        while (std::getline(file, line)) {
+            view_type target;
+            if (IniBasicIncludeCache::directive(line, inSection, target)) {
+                std::error_code error;
+                std::filesystem::path include = path.parent_path() / std::filesystem::path(string_type(target));
+                std::filesystem::path resolved = std::filesystem::canonical(include, error);
+                document->includes.push_back(error ? include.lexically_normal() : resolved);
+                continue;
+            }
+            if (!line.empty() && line[0] == char_type('[')) {
+                inSection = true;
+            }
+            content += line;
+            content += char_type('\n');
+        }
+        file.close();
+        document->content << content.c_str();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->entries[path] = Entry{ stamp, document };
+        return document;
+    }
+
+    /**
+     * @brief Check whether a line is an include directive.
+     *
+     * @param line The line.
+     * @param inSection Whether a section header was seen before the line.
+     * @param target Receives the path given by the directive.
+     * @return True if the line is an include directive.
+     */
+    static bool directive(view_type line, bool inSection, view_type& target) {
+        static const char_type keyword[] = { 'i', 'n', 'c', 'l', 'u', 'd', 'e', 0 };
+        static const char_type blanks[] = { ' ', '\t', '\r', 0 };
+
+        if (!line.empty() && line.back() == char_type('\r')) {
+            line.remove_suffix(1);
+        }
+
+        if (line.size() > 2 && line.front() == char_type('[') && line.back() == char_type(']')) {
+            view_type header = line.substr(1, line.size() - 2);
+            view_type prefix(keyword);
+            if (header.size() > prefix.size() && header.substr(0, prefix.size()) == prefix &&
+                (header[prefix.size()] == char_type(' ') || header[prefix.size()] == char_type('\t'))) {
+                target = IniBasicIncludeCache::trim(header.substr(prefix.size()), blanks);
+                return !target.empty();
+            }
+            return false;
+        }
+
+        std::size_t equalPos = line.find(char_type('='));
+        if (inSection || equalPos == view_type::npos || IniBasicIncludeCache::trim(line.substr(0, equalPos), blanks) != keyword) {
+            return false;
+        }
+        target = IniBasicIncludeCache::trim(line.substr(equalPos + 1), blanks);
+        return !target.empty();
+    }
+
+    static view_type trim(view_type text, const char_type* blanks) {
+        std::size_t first = text.find_first_not_of(blanks);
+        if (first == view_type::npos) {
+            return view_type();
+        }
+        return text.substr(first, text.find_last_not_of(blanks) - first + 1);
+    }
+
+    /**
+     * @brief Merge a file after its includes, depth first.
+     */
+    void merge_into(Parser& merged, const std::filesystem::path& path,
+        const std::map<std::filesystem::path, std::shared_ptr<const Document>>& documents,
+        std::vector<std::filesystem::path>& stack) const {
+        if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+            throw std::runtime_error("Cyclic include of an INI file");
+        }
+
+        const Document& document = *documents.at(path);
+        stack.push_back(path);
+        for (const auto& include : document.includes) {
+            this->merge_into(merged, include, documents, stack);
+        }
+        merged.merge(document.content);
+        stack.pop_back();
+    }
+
+    mutable std::mutex mutex;
+    std::map<std::filesystem::path, Entry> entries;
+};
+
+/**
+ * @brief Include cache for IniParserA.
+ */
+typedef IniBasicIncludeCache<IniParserA>    IniIncludeCacheA;
+
+/**
+ * @brief Include cache for IniParserW.
+ */
+typedef IniBasicIncludeCache<IniParserW>    IniIncludeCacheW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the include cache type based on whether the _UNICODE macro is defined.
+ */
+# define IniIncludeCache    IniIncludeCacheW
+
+#else
+
+/**
+ * @brief Macro that defines the include cache type based on whether the _UNICODE macro is defined.
+ */
+# define IniIncludeCache    IniIncludeCacheA
+
+#endif
@@ -0,0 +1,479 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <cstdlib>
+#include                    <cstring>
+#include                    <string>
+#include                    <string_view>
+#include                    <vector>
+#include                    <map>
+#include                    <utility>
+#include                    <stdexcept>
+#include                    <algorithm>
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+#pragma region              helpers
+
+/**
+ * @brief Read an environment variable.
+ *
+ * @param name The name of the variable.
+ * @return The value of the variable, or an empty string if it is not set.
+ */
+inline std::string IniEnvironmentValue(const std::string& name) {
+    const char* value = std::getenv(name.c_str());
+    return value ? std::string(value) : std::string();
+}
+
+/**
+ * @brief Read an environment variable.
+ *
+ * Outside Windows, the value is converted from the multibyte encoding of the current C locale.
+ *
+ * @param name The name of the variable.
+ * @return The value of the variable, or an empty string if it is not set.
+ */
+inline std::wstring IniEnvironmentValue(const std::wstring& name) {
+#if defined(_WIN32)
+    const wchar_t* value = _wgetenv(name.c_str());
+    return value ? std::wstring(value) : std::wstring();
+#else
+    std::string narrowName(name.begin(), name.end());
+    const char* value = std::getenv(narrowName.c_str());
+    if (value == nullptr) {
+        return std::wstring();
+    }
+
+    std::size_t size = std::strlen(value);
+    std::wstring wide(size, L'\0');
+    std::size_t length = std::mbstowcs(&wide[0], value, size);
+    if (length == static_cast<std::size_t>(-1)) {
+        return std::wstring(value, value + size);
+    }
+    wide.resize(length);
+    return wide;
+#endif
+}
+
+#pragma endregion
+
+/**
+ * @brief A view of a parser that expands references in values.
+ *
+ * A value may refer to other values with "${section:key}", or "${key}" for a key of the same section,
+ * and to environment variables with "${ENV:NAME}". "$$" stands for a single '$'. References to keys
+ * that do not exist expand to an empty string, and a '$' that does not start a reference is kept as is.
+ *
+ * Values are expanded on first read and the result is memoized. The references between values form
+ * a dependency graph: changing a key through set(), rem() or load() drops the memoized values of the
+ * keys that depend on it, directly or not, and nothing else. Values without a '$' are returned from the
+ * parser as they are. Environment variables are read once; call invalidate() to read them again.
+ *
+ * Like IniParser, the view is not synchronized: reads update the memoized values, so concurrent readers need their own lock.
+ */
+template <typename Parser>
+class IniBasicInterpolated {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+    typedef std::basic_string_view<char_type>       view_type;
+
+    /**
+     * @brief Default constructor. Creates a view of an empty parser.
+     */
+    IniBasicInterpolated() {}
+
+    /**
+     * @brief Create a view of a parser.
+     *
+     * @param ini The parser holding the unexpanded values.
+     */
+    explicit IniBasicInterpolated(Parser ini) : ini(std::move(ini)) {}
+
+    /**
+     * @brief Get a read-only reference to the parser holding the unexpanded values.
+     *
+     * @return The parser.
+     */
+    const Parser& parser() const {
+        return this->ini;
+    }
+
+    /**
+     * @brief Find the expanded value of a key.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return A pointer to the expanded value, or nullptr if the key does not exist. The pointer is
+     *         invalidated by any change made through the view.
+     * @throws std::runtime_error If the value refers to itself, directly or through other values.
+     */
+    const string_type* lookup(view_type section, view_type key) {
+        const string_type* raw = this->ini.lookup(section, key);
+        if (raw == nullptr || raw->find(char_type('$')) == string_type::npos) {
+            return raw;
+        }
+
+        Entry& entry = this->graph_entry(section, key);
+        if (entry.second.state != Resolved) {
+            this->resolve(entry, *raw);
+        }
+        return &entry.second.value;
+    }
+
+    /**
+     * @brief Get the expanded value of a key in a section.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The expanded value of the key-value pair, or an empty string if the key does not exist.
+     * @throws std::runtime_error If the value refers to itself, directly or through other values.
+     */
+    template <typename __T__ = string_type>
+    __T__ get(view_type section, view_type key) {
+        const string_type* value = this->lookup(section, key);
+        return static_cast<__T__>(value ? *value : string_type());
+    }
+
+    /**
+     * @brief Check if a key exists.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return True if the key exists with a non-empty value, as for the parser, false otherwise.
+     */
+    bool exist(view_type section, view_type key) const {
+        const string_type* value = this->ini.lookup(section, key);
+        return value != nullptr && !value->empty();
+    }
+
+    /**
+     * @brief Set the unexpanded value of a key.
+     *
+     * The memoized values of the keys referring to it are dropped.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set. It may contain references.
+     */
+    template <typename __T__ = string_type>
+    void set(const char_type* section, const char_type* key, const __T__& value) {
+        this->ini.set(section, key, value);
+        this->invalidate(section, key);
+    }
+
+    /**
+     * @brief Delete a key.
+     *
+     * References to the key expand to an empty string from now on.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair to delete.
+     */
+    void rem(view_type section, view_type key) {
+        this->ini.rem(section, key);
+        this->invalidate(section, key);
+    }
+
+    /**
+     * @brief Delete a section and all its key-value pairs.
+     *
+     * @param section The section to delete.
+     */
+    void rem(view_type section) {
+        this->ini.rem(section);
+        for (auto it = this->graph.lower_bound(std::make_pair(section, view_type())); it != this->graph.end() && view_type(it->first.first) == section; ++it) {
+            this->invalidate(*it);
+        }
+    }
+
+    /**
+     * @brief Replace the unexpanded values.
+     *
+     * Only the memoized values depending on a key whose value differs between the two parsers are dropped.
+     *
+     * @param ini The new content of the view.
+     */
+    void load(Parser&& ini) {
+        std::vector<Entry*> changed;
+        for (auto& entry : this->graph) {
+            const string_type* before = this->ini.lookup(entry.first.first, entry.first.second);
+            const string_type* after = ini.lookup(entry.first.first, entry.first.second);
+            if ((before == nullptr) != (after == nullptr) || (before != nullptr && *before != *after)) {
+                changed.push_back(&entry);
+            }
+        }
+
+        this->ini = std::move(ini);
+        for (Entry* entry : changed) {
+            this->invalidate(*entry);
+        }
+    }
+
+    /**
+     * @brief Reload the unexpanded values from an INI file.
+     *
+     * The view is changed only if the file could be opened.
+     *
+     * @param filename The name of the INI file to parse.
+     * @return True if the file was successfully parsed, false otherwise.
+     */
+    bool reload(const char_type* filename) {
+        Parser fresh;
+        if (!(fresh >> filename)) {
+            return false;
+        }
+        this->load(std::move(fresh));
+        return true;
+    }
+
+    /**
+     * @brief Expand every value now rather than on first read.
+     *
+     * @throws std::runtime_error If a value refers to itself, directly or through other values.
+     */
+    void resolve_all() {
+        for (const auto& section : this->ini.view()) {
+            for (const auto& pair : section.second) {
+                this->lookup(section.first, pair.first);
+            }
+        }
+    }
+
+    /**
+     * @brief Drop every memoized value and environment variable.
+     *
+     * Call this after modifying the environment, or the parser through a handle other than the view.
+     */
+    void invalidate() {
+        this->graph.clear();
+        this->environment.clear();
+    }
+
+private:
+    typedef std::pair<string_type, string_type> key_type;
+
+    /**
+     * @brief Order (section, key) pairs of strings or string views alike.
+     */
+    struct KeyLess {
+        typedef void is_transparent;
+
+        template <typename Left, typename Right>
+        bool operator()(const Left& left, const Right& right) const {
+            int order = view_type(left.first).compare(view_type(right.first));
+            return order < 0 || (order == 0 && view_type(left.second) < view_type(right.second));
+        }
+    };
+
+    enum State {
+        Unresolved = 0,
+        Resolving,
+        Resolved
+    };
+
+    struct Node;
+    typedef std::pair<const key_type, Node> Entry;
+
+    /**
+     * @brief A key of the dependency graph.
+     *
+     * Keys without references are only added to record the keys that depend on them.
+     */
+    struct Node {
+        State state = Unresolved;
+        string_type value;
+        std::vector<Entry*> dependencies;
+        std::vector<Entry*> dependents;
+    };
+
+    /**
+     * @brief Get the node of a key, adding it to the graph if needed.
+     */
+    Entry& graph_entry(view_type section, view_type key) {
+        auto it = this->graph.lower_bound(std::make_pair(section, key));
+        if (it == this->graph.end() || KeyLess()(std::make_pair(section, key), it->first)) {
+            it = this->graph.emplace_hint(it, key_type(section, key), Node());
+        }
+        return *it;
+    }
+
+    /**
+     * @brief Expand the value of a key and memoize it.
+     */
+    void resolve(Entry& entry, view_type raw) {
+        Node& node = entry.second;
+        if (node.state == Resolving) {
+            throw std::runtime_error("Cyclic reference in an interpolated value");
+        }
+
+        node.state = Resolving;
+        try {
+            string_type value;
+            value.reserve(raw.size());
+            this->expand(entry, raw, value);
+            node.value = std::move(value);
+            node.state = Resolved;
+        }
+        catch (...) {
+            this->unlink(entry);
+            node.state = Unresolved;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Append the expansion of a raw value to a string.
+     */
+    void expand(Entry& entry, view_type raw, string_type& out) {
+        static const char_type environmentSection[] = { 'E', 'N', 'V', 0 };
+
+        std::size_t i = 0;
+        while (i < raw.size()) {
+            std::size_t dollar = raw.find(char_type('$'), i);
+            if (dollar == view_type::npos) {
+                out.append(raw.substr(i));
+                break;
+            }
+            out.append(raw.substr(i, dollar - i));
+
+            if (dollar + 1 < raw.size() && raw[dollar + 1] == char_type('$')) {
+                out += char_type('$');
+                i = dollar + 2;
+                continue;
+            }
+
+            std::size_t close = view_type::npos;
+            if (dollar + 1 < raw.size() && raw[dollar + 1] == char_type('{')) {
+                close = raw.find(char_type('}'), dollar + 2);
+            }
+            if (close == view_type::npos) {
+                out += char_type('$');
+                i = dollar + 1;
+                continue;
+            }
+
+            view_type reference = raw.substr(dollar + 2, close - dollar - 2);
+            std::size_t colon = reference.find(char_type(':'));
+            if (colon == view_type::npos) {
+                out.append(this->reference(entry, entry.first.first, reference));
+            }
+            else if (reference.substr(0, colon) == environmentSection) {
+                out.append(this->environment_value(reference.substr(colon + 1)));
+            }
+            else {
+                out.append(this->reference(entry, reference.substr(0, colon), reference.substr(colon + 1)));
+            }
+            i = close + 1;
+        }
+    }
+
+    /**
+     * @brief Record that a key depends on another one and get the expanded value of the latter.
+     */
+    view_type reference(Entry& dependent, view_type section, view_type key) {
+        Entry& target = this->graph_entry(section, key);
+        dependent.second.dependencies.push_back(&target);
+        target.second.dependents.push_back(&dependent);
+
+        const string_type* raw = this->ini.lookup(section, key);
+        if (raw == nullptr) {
+            return view_type();
+        }
+        if (raw->find(char_type('$')) == string_type::npos) {
+            return *raw;
+        }
+        if (target.second.state != Resolved) {
+            this->resolve(target, *raw);
+        }
+        return target.second.value;
+    }
+
+    /**
+     * @brief Get an environment variable, reading it on first use.
+     */
+    view_type environment_value(view_type name) {
+        auto it = this->environment.find(name);
+        if (it == this->environment.end()) {
+            string_type key(name);
+            string_type value = IniEnvironmentValue(key);
+            it = this->environment.emplace(std::move(key), std::move(value)).first;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Drop the memoized value of a key and of every key depending on it.
+     */
+    void invalidate(view_type section, view_type key) {
+        auto it = this->graph.find(std::make_pair(section, key));
+        if (it != this->graph.end()) {
+            this->invalidate(*it);
+        }
+    }
+
+    void invalidate(Entry& changed) {
+        std::vector<Entry*> pending(1, &changed);
+        while (!pending.empty()) {
+            Entry& entry = *pending.back();
+            pending.pop_back();
+
+            Node& node = entry.second;
+            pending.insert(pending.end(), node.dependents.begin(), node.dependents.end());
+            node.dependents.clear();
+
+            this->unlink(entry);
+            node.state = Unresolved;
+            node.value = string_type();
+        }
+    }
+
+    /**
+     * @brief Remove the edges from a key to the keys it refers to.
+     */
+    void unlink(Entry& entry) {
+        for (Entry* dependency : entry.second.dependencies) {
+            auto& dependents = dependency->second.dependents;
+            auto it = std::find(dependents.begin(), dependents.end(), &entry);
+            if (it != dependents.end()) {
+                *it = dependents.back();
+                dependents.pop_back();
+            }
+        }
+        entry.second.dependencies.clear();
+    }
+
+    Parser ini;
+    std::map<key_type, Node, KeyLess> graph;
+    std::map<string_type, string_type, std::less<>> environment;
+};
+
+/**
+ * @brief Interpolating view of an IniParserA.
+ */
+typedef IniBasicInterpolated<IniParserA>    IniInterpolatedA;
+
+/**
+ * @brief Interpolating view of an IniParserW.
+ */
+typedef IniBasicInterpolated<IniParserW>    IniInterpolatedW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the interpolating view type based on whether the _UNICODE macro is defined.
+ */
+# define IniInterpolated    IniInterpolatedW
+
+#else
+
+/**
+ * @brief Macro that defines the interpolating view type based on whether the _UNICODE macro is defined.
+ */
+# define IniInterpolated    IniInterpolatedA
+
+#endif
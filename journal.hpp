@@ -0,0 +1,686 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <algorithm>
+#include                    <cstdio>
+#include                    <cstdint>
+#include                    <cstring>
+#include                    <string>
+#include                    <chrono>
+#include                    <thread>
+#include                    <mutex>
+#include                    <condition_variable>
+#include                    <filesystem>
+#include                    <stdexcept>
+
+#if defined(_WIN32)
+#include                    <io.h>
+#else
+#include                    <unistd.h>
+#endif
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+#pragma region              helpers
+
+/**
+ * @brief Open a journal file with a C stdio mode, for example "ab".
+ */
+inline std::FILE* IniJournalOpen(const std::filesystem::path& path, const char* mode) {
+#if defined(_WIN32)
+    std::wstring wideMode(mode, mode + std::strlen(mode));
+    return _wfopen(path.c_str(), wideMode.c_str());
+#else
+    return std::fopen(path.c_str(), mode);
+#endif
+}
+
+/**
+ * @brief Flush a journal file and wait until its content reaches the disk.
+ *
+ * @return True on success, false otherwise.
+ */
+inline bool IniJournalSync(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/**
+ * @brief 32-bit FNV-1a checksum of a journal record.
+ */
+inline std::uint32_t IniJournalChecksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+#pragma endregion
+
+/**
+ * @brief Journal mode for a parser whose values change often.
+ *
+ * Instead of rewriting the whole INI file on every change, set() and rem() apply the change to the
+ * parser and append a small binary record to a side log, "<filename>.log". Records are written and
+ * synced to disk in groups by a background thread, so persisting a change costs one append, not a
+ * rewrite of the file. sync() waits until every change made so far is on disk.
+ *
+ * When the journal is opened, the INI file is parsed and the log is replayed on top of it. A torn
+ * record at the end of the log, left by a crash during an append, is dropped.
+ *
+ * Once the log grows past a threshold, it is compacted: the content of the parser is written to
+ * "<filename>.tmp", which then replaces the INI file, and the log is emptied. Replaying records
+ * that are already part of the INI file gives the same result, so a crash at any point of the
+ * compaction loses nothing.
+ *
+ * When the log cannot be written, the records are kept in memory and written again, from the first
+ * byte that did not reach the file, by the next group commit; sync() throws until they are synced.
+ * A failed compaction is only tried again once the log has grown by another threshold. A successful
+ * one also makes the kept records durable, since the INI file it writes holds every change.
+ *
+ * The parser must only be modified through the journal while it is open. Reading it from other
+ * threads needs the lock returned by mutex().
+ */
+template <typename Parser>
+class IniBasicJournal {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+
+    /**
+     * @brief Tuning of the group commit and of the compaction.
+     */
+    struct Options {
+        /**
+         * @brief Number of buffered bytes that triggers a write of the log before the interval elapses.
+         */
+        std::size_t groupBytes = 64 * 1024;
+
+        /**
+         * @brief Longest time a change stays in memory before it is written and synced.
+         */
+        std::chrono::milliseconds syncInterval = std::chrono::milliseconds(20);
+
+        /**
+         * @brief Size of the log, in bytes, past which it is folded back into the INI file.
+         */
+        std::uintmax_t compactBytes = 1024 * 1024;
+
+        /**
+         * @brief Write the log from a background thread. If false, the log is written by set(), rem() and sync().
+         */
+        bool background = true;
+    };
+
+    /**
+     * @brief Open a journal: parse the INI file, replay its log and start the background thread.
+     *
+     * A missing INI file or log is treated as empty.
+     *
+     * @param target The parser holding the configuration. Its current content is replaced; its dialect is kept.
+     * @param filename The name of the INI file.
+     * @param options The tuning of the journal.
+     * @throws std::runtime_error If the log is not a journal of this character type or cannot be opened.
+     */
+    IniBasicJournal(Parser& target, const char_type* filename, Options options = Options())
+        : target(target), options(options), iniPath(filename), logPath(filename), file(nullptr),
+          logSize(0), compactAt(options.compactBytes), appended(0), durable(0), flushes(0), replayedRecords(0),
+          unsynced(false), failed(false), stopping(false) {
+        this->logPath += ".log";
+
+        this->target = Parser(this->target.dialect());
+        this->target >> filename;
+
+        this->replay();
+
+        this->file = this->open_log("ab");
+        if (!this->file) {
+            throw std::runtime_error("Failed to open the journal");
+        }
+        if (this->logSize == 0 && !this->write_header()) {
+            std::fclose(this->file);
+            throw std::runtime_error("Failed to write the journal header");
+        }
+
+        if (this->options.background) {
+            this->worker = std::thread(&IniBasicJournal::run, this);
+        }
+    }
+
+    IniBasicJournal(const IniBasicJournal&) = delete;
+    IniBasicJournal& operator=(const IniBasicJournal&) = delete;
+
+    /**
+     * @brief Destructor. Writes and syncs the pending records, then closes the log.
+     */
+    ~IniBasicJournal() {
+        if (this->worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(this->dataMutex);
+                this->stopping = true;
+            }
+            this->wake.notify_all();
+            this->worker.join();
+        }
+        this->flush();
+        if (this->file) {
+            std::fclose(this->file);
+        }
+    }
+
+    /**
+     * @brief Set the value of a key in a section and log the change.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    template <typename __T__ = string_type>
+    void set(const char_type* section, const char_type* key, const __T__& value) {
+        this->set(section, key, Parser::format_value(value));
+    }
+
+    /**
+     * @brief Set the value of a key in a section and log the change, taking ownership of the string.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    void set(const char_type* section, const char_type* key, string_type&& value) {
+        std::unique_lock<std::mutex> lock(this->dataMutex);
+        this->append(RecordSet, section, key, value);
+        this->target.set(section, key, std::move(value));
+        this->after_append(lock);
+    }
+
+    /**
+     * @brief Delete a key from a section and log the change.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair to delete.
+     */
+    void rem(const char_type* section, const char_type* key) {
+        std::unique_lock<std::mutex> lock(this->dataMutex);
+        this->append(RecordRemoveKey, section, key, string_type());
+        this->target.rem(section, key);
+        this->after_append(lock);
+    }
+
+    /**
+     * @brief Delete a section and log the change.
+     *
+     * @param section The section to delete.
+     */
+    void rem(const char_type* section) {
+        std::unique_lock<std::mutex> lock(this->dataMutex);
+        this->append(RecordRemoveSection, section, string_type(), string_type());
+        this->target.rem(section);
+        this->after_append(lock);
+    }
+
+    /**
+     * @brief Get the value of a key in a section.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The value of the key-value pair, or an empty string if the key does not exist.
+     */
+    template <typename __T__ = string_type>
+    __T__ get(const char_type* section, const char_type* key) {
+        std::lock_guard<std::mutex> lock(this->dataMutex);
+        return this->target.template get<__T__>(section, key);
+    }
+
+    /**
+     * @brief Wait until every change made so far is written and synced to disk.
+     *
+     * @throws std::runtime_error If the log could not be written. The changes are kept and written
+     * again by the next group commit, so a later call may succeed.
+     */
+    void sync() {
+        std::unique_lock<std::mutex> lock(this->dataMutex);
+        std::uint64_t wanted = this->appended;
+
+        if (this->worker.joinable()) {
+            // Wait for a write attempted after this call, not for the outcome of an earlier one.
+            std::uint64_t attempt = this->flushes;
+            this->syncRequested = true;
+            this->wake.notify_all();
+            this->synced.wait(lock, [&] { return this->durable >= wanted || (this->failed && this->flushes != attempt); });
+        }
+        else {
+            lock.unlock();
+            this->flush();
+            lock.lock();
+        }
+
+        if (this->failed) {
+            throw std::runtime_error("Failed to write the journal");
+        }
+    }
+
+    /**
+     * @brief Fold the log back into the INI file now.
+     *
+     * @return True if the INI file was rewritten and the log emptied, false otherwise.
+     */
+    bool compact() {
+        std::lock_guard<std::mutex> io(this->ioMutex);
+        return this->compact_io();
+    }
+
+    /**
+     * @brief Get the number of records replayed when the journal was opened.
+     *
+     * @return The number of replayed records.
+     */
+    std::size_t replayed() const {
+        return this->replayedRecords;
+    }
+
+    /**
+     * @brief Get the lock that guards the parser.
+     *
+     * @return The mutex held by the journal while it modifies the parser.
+     */
+    std::mutex& mutex() {
+        return this->dataMutex;
+    }
+
+private:
+    enum RecordKind : unsigned char {
+        RecordSet = 1,
+        RecordRemoveKey,
+        RecordRemoveSection
+    };
+
+    /**
+     * @brief Size of the fixed part of a record, before its fields: the kind and the three lengths.
+     */
+    static constexpr std::size_t RecordHeaderSize = 1 + 3 * sizeof(std::uint32_t);
+
+    static constexpr char Magic[8] = { 'X', 'I', 'N', 'I', 'J', 'R', 'N', 'L' };
+
+    static constexpr std::size_t FileHeaderSize = sizeof(Magic) + 1;
+
+    /**
+     * @brief Encode a record at the end of the pending buffer. Called with the mutex held.
+     */
+    void append(RecordKind kind, std::basic_string_view<char_type> section,
+        std::basic_string_view<char_type> key, std::basic_string_view<char_type> value) {
+        std::size_t start = this->pending.size();
+
+        this->pending.push_back(static_cast<char>(kind));
+        for (std::basic_string_view<char_type> field : { section, key, value }) {
+            std::uint32_t length = static_cast<std::uint32_t>(field.size());
+            this->pending.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        }
+        for (std::basic_string_view<char_type> field : { section, key, value }) {
+            this->pending.append(reinterpret_cast<const char*>(field.data()), field.size() * sizeof(char_type));
+        }
+
+        std::uint32_t checksum = IniJournalChecksum(this->pending.data() + start, this->pending.size() - start);
+        this->pending.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+        ++this->appended;
+    }
+
+    void after_append(std::unique_lock<std::mutex>& lock) {
+        if (this->pending.size() < this->options.groupBytes) {
+            return;
+        }
+        if (this->worker.joinable()) {
+            this->wake.notify_all();
+        }
+        else {
+            lock.unlock();
+            this->flush();
+        }
+    }
+
+    /**
+     * @brief Write and sync the pending records, then compact the log if it grew too large.
+     */
+    void flush() {
+        std::lock_guard<std::mutex> io(this->ioMutex);
+        this->flush_io();
+        // The records that could not be written count, so that a failing log still gets compacted.
+        if (this->logSize + this->unwritten.size() >= this->compactAt) {
+            this->compact_io();
+        }
+    }
+
+    /**
+     * @brief Write and sync the pending records, after those a previous call could not write. Called with the I/O lock held.
+     */
+    void flush_io() {
+        std::uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(this->dataMutex);
+            if (this->unwritten.empty()) {
+                this->unwritten.swap(this->pending);
+            }
+            else {
+                this->unwritten += this->pending;
+                this->pending.clear();
+            }
+            sequence = this->appended;
+            this->syncRequested = false;
+        }
+
+        if (!this->unwritten.empty() && this->file) {
+            // Only the bytes that reached the file are dropped, so a retry resumes inside the same record.
+            std::clearerr(this->file);
+            std::size_t written = std::fwrite(this->unwritten.data(), 1, this->unwritten.size(), this->file);
+            this->unwritten.erase(0, written);
+            this->logSize += written;
+            this->unsynced = this->unsynced || written > 0;
+        }
+
+        bool ok = this->unwritten.empty();
+        if (ok && this->unsynced) {
+            ok = IniJournalSync(this->file);
+            this->unsynced = !ok;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->dataMutex);
+            if (ok) {
+                this->durable = sequence;
+            }
+            this->failed = !ok;
+            ++this->flushes;
+        }
+        this->synced.notify_all();
+    }
+
+    /**
+     * @brief Compact the log, and put off the next attempt by another threshold if it fails. Called with the I/O lock held.
+     */
+    bool compact_io() {
+        std::uint64_t covered = 0;
+        bool ok = this->rewrite_io(covered);
+
+        if (ok) {
+            this->compactAt = this->options.compactBytes;
+            {
+                // Every record written before the snapshot is part of the INI file now, including those the log lost.
+                std::lock_guard<std::mutex> lock(this->dataMutex);
+                this->durable = std::max(this->durable, covered);
+                this->failed = false;
+            }
+            this->synced.notify_all();
+        }
+        else {
+            this->compactAt = this->logSize + this->unwritten.size() + this->options.compactBytes;
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Rewrite the INI file from the parser and empty the log. Called with the I/O lock held.
+     *
+     * @param covered Receives the number of records the new INI file holds.
+     */
+    bool rewrite_io(std::uint64_t& covered) {
+        this->flush_io();
+
+        Parser snapshot(this->target.dialect());
+        {
+            // Changes made after this point are still appended to the log, and replayed over the new file.
+            std::lock_guard<std::mutex> lock(this->dataMutex);
+            snapshot.loadmap(this->target.view());
+            // loadmap() forgets the repeated values of the keys, which commit() writes back as several lines.
+            snapshot.repeated = this->target.repeated;
+            covered = this->appended;
+        }
+
+        std::filesystem::path tmpPath = this->iniPath;
+        tmpPath += ".tmp";
+
+        if (!snapshot.commit(PathString(tmpPath).c_str())) {
+            return false;
+        }
+
+        std::FILE* tmp = IniJournalOpen(tmpPath, "rb+");
+        bool ok = tmp && IniJournalSync(tmp);
+        if (tmp) {
+            std::fclose(tmp);
+        }
+
+        std::error_code error;
+        if (!ok || (std::filesystem::rename(tmpPath, this->iniPath, error), error)) {
+            return false;
+        }
+
+        // The records the log could not take were made before the snapshot, so the INI file holds them.
+        this->unwritten.clear();
+        this->unsynced = false;
+
+        if (this->file) {
+            std::fclose(this->file);
+        }
+        this->file = this->open_log("wb");
+        this->logSize = 0;
+        if (!this->file || !this->write_header()) {
+            // Nothing is appended to a log without its header: the records are kept until a compaction opens it again.
+            if (this->file) {
+                std::fclose(this->file);
+                this->file = nullptr;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Open the log without a stdio buffer, so that fwrite() reports the bytes the file actually took.
+     */
+    std::FILE* open_log(const char* mode) {
+        std::FILE* log = IniJournalOpen(this->logPath, mode);
+        if (log) {
+            std::setvbuf(log, nullptr, _IONBF, 0);
+        }
+        return log;
+    }
+
+    bool write_header() {
+        unsigned char charSize = sizeof(char_type);
+        bool ok = std::fwrite(Magic, 1, sizeof(Magic), this->file) == sizeof(Magic) &&
+            std::fwrite(&charSize, 1, 1, this->file) == 1 && IniJournalSync(this->file);
+        this->logSize = FileHeaderSize;
+        return ok;
+    }
+
+    /**
+     * @brief Apply the records of the log to the parser, dropping a torn record at its end.
+     */
+    void replay() {
+        std::FILE* log = IniJournalOpen(this->logPath, "rb");
+        if (!log) {
+            return;
+        }
+
+        std::string content;
+        char chunk[64 * 1024];
+        std::size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), log)) > 0) {
+            content.append(chunk, read);
+        }
+        std::fclose(log);
+
+        if (content.size() < FileHeaderSize) {
+            // A crash while the header was written: start the log again.
+            std::filesystem::remove(this->logPath);
+            return;
+        }
+        if (std::memcmp(content.data(), Magic, sizeof(Magic)) != 0 ||
+            static_cast<unsigned char>(content[sizeof(Magic)]) != sizeof(char_type)) {
+            throw std::runtime_error("The file is not a journal of this character type");
+        }
+
+        std::size_t offset = FileHeaderSize;
+        while (content.size() - offset >= RecordHeaderSize + sizeof(std::uint32_t)) {
+            const char* record = content.data() + offset;
+
+            std::uint32_t lengths[3];
+            std::memcpy(lengths, record + 1, sizeof(lengths));
+
+            std::uint64_t payload = (static_cast<std::uint64_t>(lengths[0]) + lengths[1] + lengths[2]) * sizeof(char_type);
+            if (content.size() - offset - RecordHeaderSize - sizeof(std::uint32_t) < payload) {
+                break;
+            }
+
+            std::size_t size = RecordHeaderSize + static_cast<std::size_t>(payload);
+            std::uint32_t checksum;
+            std::memcpy(&checksum, record + size, sizeof(checksum));
+            if (checksum != IniJournalChecksum(record, size)) {
+                break;
+            }
+
+            // The fields are not aligned for wide characters, so they are copied rather than cast.
+            const char* fields = record + RecordHeaderSize;
+            string_type section(lengths[0], char_type());
+            string_type key(lengths[1], char_type());
+            string_type value(lengths[2], char_type());
+            std::memcpy(&section[0], fields, lengths[0] * sizeof(char_type));
+            std::memcpy(&key[0], fields + lengths[0] * sizeof(char_type), lengths[1] * sizeof(char_type));
+            std::memcpy(&value[0], fields + (lengths[0] + lengths[1]) * sizeof(char_type), lengths[2] * sizeof(char_type));
+
+            switch (static_cast<unsigned char>(record[0])) {
+            case RecordSet:
+                this->target.set(section.c_str(), key.c_str(), std::move(value));
+                break;
+            case RecordRemoveKey:
+                this->target.rem(section.c_str(), key.c_str());
+                break;
+            case RecordRemoveSection:
+                this->target.rem(section.c_str());
+                break;
+            }
+
+            offset += size + sizeof(std::uint32_t);
+            ++this->replayedRecords;
+        }
+
+        if (offset != content.size()) {
+            std::filesystem::resize_file(this->logPath, offset);
+        }
+        this->logSize = offset;
+    }
+
+    /**
+     * @brief Background thread: group commit and compaction.
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(this->dataMutex);
+        while (!this->stopping) {
+            this->wake.wait_for(lock, this->options.syncInterval, [&] {
+                return this->stopping || this->syncRequested || this->pending.size() >= this->options.groupBytes;
+            });
+
+            lock.unlock();
+            this->flush();
+            lock.lock();
+        }
+    }
+
+    static string_type PathString(const std::filesystem::path& path) {
+        if constexpr (std::is_same_v<char_type, wchar_t>) {
+            return path.wstring();
+        }
+        else {
+            return path.string();
+        }
+    }
+
+    Parser& target;
+    Options options;
+    std::filesystem::path iniPath;
+    std::filesystem::path logPath;
+    std::FILE* file;
+    std::uintmax_t logSize;
+
+    /**
+     * @brief Size of the log past which it is compacted: the threshold, raised after a failed compaction.
+     */
+    std::uintmax_t compactAt;
+
+    /**
+     * @brief Records taken from the pending buffer that did not reach the log yet. Guarded by the I/O lock.
+     */
+    std::string unwritten;
+
+    /**
+     * @brief Guards the parser and the pending records.
+     */
+    std::mutex dataMutex;
+
+    /**
+     * @brief Serializes writes to the log and compactions.
+     */
+    std::mutex ioMutex;
+
+    std::condition_variable wake;
+    std::condition_variable synced;
+    std::thread worker;
+
+    std::string pending;
+    std::uint64_t appended;
+    std::uint64_t durable;
+
+    /**
+     * @brief Number of group commits attempted, so that sync() waits for one it requested.
+     */
+    std::uint64_t flushes;
+    std::size_t replayedRecords;
+
+    /**
+     * @brief Whether bytes were written to the log since its last successful sync. Guarded by the I/O lock.
+     */
+    bool unsynced;
+
+    /**
+     * @brief Whether the last group commit failed.
+     */
+    bool failed;
+    bool stopping;
+    bool syncRequested = false;
+};
+
+/**
+ * @brief Journal over an IniParserA.
+ */
+typedef IniBasicJournal<IniParserA>     IniJournalA;
+
+/**
+ * @brief Journal over an IniParserW.
+ */
+typedef IniBasicJournal<IniParserW>     IniJournalW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the journal type based on whether the _UNICODE macro is defined.
+ */
+# define IniJournal         IniJournalW
+
+#else
+
+/**
+ * @brief Macro that defines the journal type based on whether the _UNICODE macro is defined.
+ */
+# define IniJournal         IniJournalA
+
+#endif
@@ -0,0 +1,363 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <vector>
+#include                    <memory>
+#include                    <functional>
+#include                    <stdexcept>
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+/**
+ * @brief A copy-free, layered view over a stack of parsers.
+ *
+ * Instead of materializing a merged parser, the view keeps an ordered stack of layers (for example
+ * defaults, site, host and environment) and answers lookups by probing from the top layer down.
+ * Writes only ever go to the top layer, and reloading one layer only costs the parse of that layer.
+ *
+ * Recent successful lookups are kept in a small direct-mapped cache. The cache is invalidated by every
+ * change made through the view. A layer shared between views counts the changes made to it through any
+ * of them, and a lookup drops the cache when one of its layers has changed since it was filled.
+ *
+ * Like IniParser, the view is not synchronized: lookups update the cache, so concurrent readers need their own lock.
+ */
+template <typename Parser>
+class IniBasicLayered {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+    typedef std::basic_string_view<char_type>       view_type;
+
+    /**
+     * @brief Number of slots of the lookup cache.
+     */
+    static constexpr std::size_t CacheSize = 64;
+
+    /**
+     * @brief A layer that can be shared between several views.
+     *
+     * The parser is only writable through the views, which count every change they make to it.
+     */
+    class Layer {
+    public:
+        Layer() : generation(0) {}
+        explicit Layer(Parser&& parser) : content(std::move(parser)), generation(0) {}
+
+        /**
+         * @brief Get a read-only reference to the parser of the layer.
+         *
+         * @return The parser of the layer.
+         */
+        const Parser& parser() const {
+            return this->content;
+        }
+
+    private:
+        friend class IniBasicLayered;
+
+        Parser content;
+        std::size_t generation;
+    };
+
+    /**
+     * @brief Default constructor. Creates a view without layers.
+     */
+    IniBasicLayered() : generation(1), cache() {}
+
+    /**
+     * @brief Push a layer on top of the stack.
+     *
+     * @param layer The parser to push. It becomes the top layer.
+     * @return The index of the new layer.
+     */
+    std::size_t push(Parser&& layer) {
+        return this->push(std::make_shared<Layer>(std::move(layer)));
+    }
+
+    /**
+     * @brief Push a shared layer on top of the stack.
+     *
+     * A layer shared between several views is not copied. Writes through any of these views
+     * modify it if it is their top layer, and the other views see them on their next lookup.
+     *
+     * @param layer The layer to push, for example as returned by share(). It becomes the top layer.
+     * @return The index of the new layer.
+     */
+    std::size_t push(std::shared_ptr<Layer> layer) {
+        if (!layer) {
+            throw std::invalid_argument("Layer cannot be null");
+        }
+        std::size_t generation = layer->generation;
+        this->layers.push_back({ std::move(layer), generation });
+        this->invalidate();
+        return this->layers.size() - 1;
+    }
+
+    /**
+     * @brief Get a layer so that it can be pushed onto another view.
+     *
+     * @param index The index of the layer, 0 being the bottom layer.
+     * @return The shared layer.
+     */
+    std::shared_ptr<Layer> share(std::size_t index) const {
+        return this->layers.at(index).layer;
+    }
+
+    /**
+     * @brief Remove the top layer.
+     */
+    void pop() {
+        if (!this->layers.empty()) {
+            this->layers.pop_back();
+            this->invalidate();
+        }
+    }
+
+    /**
+     * @brief Replace a layer, leaving the others untouched.
+     *
+     * @param index The index of the layer, 0 being the bottom layer.
+     * @param layer The new content of the layer.
+     */
+    void replace(std::size_t index, Parser&& layer) {
+        this->layers.at(index) = { std::make_shared<Layer>(std::move(layer)), 0 };
+        this->invalidate();
+    }
+
+    /**
+     * @brief Reload a layer from an INI file.
+     *
+     * Only this file is parsed. The layer is replaced only if the file could be opened.
+     *
+     * @param index The index of the layer, 0 being the bottom layer.
+     * @param filename The name of the INI file to parse.
+     * @return True if the file was successfully parsed, false otherwise.
+     */
+    bool reload(std::size_t index, const char_type* filename) {
+        Parser layer;
+        if (!(layer >> filename)) {
+            return false;
+        }
+        this->replace(index, std::move(layer));
+        return true;
+    }
+
+    /**
+     * @brief Get the number of layers.
+     *
+     * @return The number of layers.
+     */
+    std::size_t size() const {
+        return this->layers.size();
+    }
+
+    /**
+     * @brief Get a read-only reference to a layer.
+     *
+     * @param index The index of the layer, 0 being the bottom layer.
+     * @return The parser of the layer.
+     */
+    const Parser& layer(std::size_t index) const {
+        return this->layers.at(index).layer->content;
+    }
+
+    /**
+     * @brief Find the value of a key, probing the layers from the top down.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return A pointer to the value in the topmost layer defining the key, or nullptr if no layer does.
+     */
+    const string_type* lookup(view_type section, view_type key) {
+        // A shared layer changed through another view may have freed the keys the cache points at.
+        for (auto& entry : this->layers) {
+            if (entry.seen != entry.layer->generation) {
+                entry.seen = entry.layer->generation;
+                this->invalidate();
+            }
+        }
+
+        std::size_t hash = std::hash<view_type>()(section) * 31 + std::hash<view_type>()(key);
+        Slot& slot = this->cache[hash % CacheSize];
+
+        if (slot.generation == this->generation && slot.hash == hash && slot.section == section && slot.key == key) {
+            return slot.value;
+        }
+
+        for (std::size_t i = this->layers.size(); i-- > 0;) {
+            const Parser& layer = this->layers[i].layer->content;
+            auto sectionIt = layer.view().find(section);
+            if (sectionIt == layer.view().end()) {
+                continue;
+            }
+            auto keyIt = sectionIt->second.find(key);
+            if (keyIt == sectionIt->second.end()) {
+                continue;
+            }
+
+            // The cached views point at the keys stored in the layer, which live as long as the generation.
+            slot.generation = this->generation;
+            slot.hash = hash;
+            slot.section = sectionIt->first;
+            slot.key = keyIt->first;
+            slot.value = &keyIt->second;
+            return slot.value;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Get the value of a key in a section.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return The value of the key-value pair in the topmost layer defining it, or an empty string if no layer does.
+     */
+    template <typename __T__ = string_type>
+    __T__ get(const char_type* section, const char_type* key) {
+        const string_type* value = this->lookup(section, key);
+        return static_cast<__T__>(value ? *value : string_type());
+    }
+
+    /**
+     * @brief Check if a key exists in any layer.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return True if the key exists with a non-empty value, as for the parser, false otherwise.
+     */
+    bool exist(const char_type* section, const char_type* key) {
+        const string_type* value = this->lookup(section, key);
+        return value != nullptr && !value->empty();
+    }
+
+    /**
+     * @brief Check if a section exists in any layer.
+     *
+     * @param section The section to check.
+     * @return True if the section exists, false otherwise.
+     */
+    bool exist(const char_type* section) const {
+        for (const auto& entry : this->layers) {
+            if (entry.layer->content.exist(section)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Set the value of a key in the top layer.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    template <typename __T__ = string_type>
+    void set(const char_type* section, const char_type* key, const __T__& value) {
+        this->top().set(section, key, value);
+        this->touch();
+    }
+
+    /**
+     * @brief Delete a key from the top layer.
+     *
+     * Lower layers are read-only through the view, so a value they define becomes visible again.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair to delete.
+     */
+    void rem(const char_type* section, const char_type* key) {
+        this->top().rem(section, key);
+        this->touch();
+    }
+
+    /**
+     * @brief Materialize the layers into a single parser.
+     *
+     * This function merges all layers, bottom to top, for example to commit the effective configuration.
+     *
+     * @return A parser holding the effective value of every key.
+     */
+    Parser flatten() const {
+        Parser flat;
+        for (const auto& entry : this->layers) {
+            flat.merge(entry.layer->content);
+        }
+        return flat;
+    }
+
+    /**
+     * @brief Drop every cached lookup.
+     */
+    void invalidate() {
+        ++this->generation;
+    }
+
+private:
+    /**
+     * @brief Get the writable top layer, creating an empty one if there are no layers.
+     */
+    Parser& top() {
+        if (this->layers.empty()) {
+            this->layers.push_back({ std::make_shared<Layer>(), 0 });
+        }
+        return this->layers.back().layer->content;
+    }
+
+    /**
+     * @brief Record a change of the top layer, for this view and for the views sharing the layer.
+     */
+    void touch() {
+        Stacked& entry = this->layers.back();
+        entry.seen = ++entry.layer->generation;
+        this->invalidate();
+    }
+
+    struct Slot {
+        std::size_t generation;
+        std::size_t hash;
+        view_type section;
+        view_type key;
+        const string_type* value;
+    };
+
+    struct Stacked {
+        std::shared_ptr<Layer> layer;
+        std::size_t seen;
+    };
+
+    std::vector<Stacked> layers;
+    std::size_t generation;
+    Slot cache[CacheSize];
+};
+
+/**
+ * @brief Layered view over IniParserA layers.
+ */
+typedef IniBasicLayered<IniParserA>     IniLayeredA;
+
+/**
+ * @brief Layered view over IniParserW layers.
+ */
+typedef IniBasicLayered<IniParserW>     IniLayeredW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the layered view type based on whether the _UNICODE macro is defined.
+ */
+# define IniLayered         IniLayeredW
+
+#else
+
+/**
+ * @brief Macro that defines the layered view type based on whether the _UNICODE macro is defined.
+ */
+# define IniLayered         IniLayeredA
+
+#endif
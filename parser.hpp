@@ -5,10 +5,22 @@
 #pragma region              includes
 
 #include                    <fstream>
+#include                    <filesystem>
 #include                    <sstream>
 #include                    <map>
+#include                    <vector>
+#include                    <iterator>
+#include                    <stdexcept>
+#include                    <string_view>
+#include                    <charconv>
+#include                    <type_traits>
+#include                    <initializer_list>
+#include                    <utility>
 
 #include                    "defs.h"
+#include                    "stats.hpp"
+#include                    "diagnostics.hpp"
+#include                    "tokenizer.hpp"
 
 #pragma endregion
 
@@ -45,8 +57,65 @@
  */
 # define IniMap             std::map<IniString, std::map<IniString, IniString>>
 
+#if defined(XINI_ENABLE_STATS)
+
+/**
+ * @brief Macro that expands to its argument when the instrumentation of the parsers is enabled.
+ *
+ * Define XINI_ENABLE_STATS to count parsed bytes, inserted keys and lookups and to time parses and
+ * commits, see IniParser::stats(). Otherwise the instrumentation compiles to nothing.
+ */
+# define XINI_STATS(statement)      statement
+
+#else
+
+/**
+ * @brief Macro that expands to its argument when the instrumentation of the parsers is enabled.
+ *
+ * Define XINI_ENABLE_STATS to count parsed bytes, inserted keys and lookups and to time parses and
+ * commits, see IniParser::stats(). Otherwise the instrumentation compiles to nothing.
+ */
+# define XINI_STATS(statement)
+
+#endif
+
 #pragma endregion
 
+/**
+ * @brief Policy applied when merging parsers that define the same key in the same section.
+ */
+enum IniMergePolicy {
+    IniMergeLastWins = 0,   ///< The value of the parser merged last is kept.
+    IniMergeFirstWins,      ///< The value that was already present is kept.
+    IniMergeError           ///< A std::runtime_error is thrown if the two values differ.
+};
+
+/**
+ * @brief The values of a key, stored contiguously in the parser.
+ *
+ * The range is invalidated like the pointer returned by IniParser::lookup().
+ */
+template <typename String>
+struct IniValueRange {
+    const String* first;
+    const String* last;
+
+    const String* begin() const { return this->first; }
+    const String* end() const { return this->last; }
+    std::size_t size() const { return static_cast<std::size_t>(this->last - this->first); }
+    bool empty() const { return this->first == this->last; }
+    const String& operator[](std::size_t index) const { return this->first[index]; }
+};
+
+template <typename Parser>
+class IniBasicTransaction;
+
+template <typename Parser>
+class IniBasicJournal;
+
+template <typename Parser>
+class IniBasicParallelWriter;
+
 /**
  * @brief A simple INI file parser class. <ASCII>
  */
@@ -57,6 +126,36 @@ public:
      */
     IniParserA() {}
 
+    /**
+     * @brief Create a parser reading a dialect of the INI syntax.
+     *
+     * @param dialect The syntax options, for example IniDialect::relaxed().
+     */
+    explicit IniParserA(const IniDialect& dialect) : syntax(dialect) {}
+
+    /**
+     * @brief Character type of the sections, keys and values.
+     */
+    typedef char char_type;
+
+    /**
+     * @brief String type of the sections, keys and values.
+     */
+    typedef std::string string_type;
+
+    /**
+     * @brief Map of the keys of a section to their values.
+     *
+     * The comparator is transparent, so keys can be looked up with a std::string_view or a char pointer
+     * without building a temporary std::string.
+     */
+    typedef std::map<std::string, std::string, std::less<>> section_type;
+
+    /**
+     * @brief Map of the sections to their keys, with a transparent comparator like section_type.
+     */
+    typedef std::map<std::string, section_type, std::less<>> data_type;
+
 private:
 
     /**
@@ -66,25 +165,200 @@ private:
      * of an INI file and stores them in the data map.
      *
      * @param currentSection The current section being parsed.
-     * @param line The line to parse.
+     * @param line The line to parse, without its newline.
      * @return True if the line was successfully parsed, false otherwise.
      */
-    bool parse_line(std::string* currentSection, const std::string& line) {
-        if (line.empty() || line[0] == ';') return false;
-        if (line[0] == '[' && line.back() == ']') {
-            *currentSection = line.substr(1, line.size() - 2);
+    bool parse_line(std::string* currentSection, std::string_view line) {
+        XINI_STATS(this->counters.parsed_line((line.size() + 1) * sizeof(char)));
+
+        auto token = IniTokenize(line, this->syntax);
+        if (token.kind == IniTokenSection) {
+            currentSection->assign(token.section);
             return false;
         }
+        if (token.kind != IniTokenPair) return false;
+        if (this->syntax.duplicates != IniDuplicateLastWins) {
+            this->parse_duplicate(*currentSection, token.key, token.value);
+            return true;
+        }
 
-        size_t equalPos = line.find('=');
-        if (equalPos == std::string::npos) return false;
-
-        std::string key = line.substr(0, equalPos);
-        std::string value = line.substr(equalPos + 1);
-        data[*currentSection][key] = value;
+        [[maybe_unused]] auto result = data[*currentSection].insert_or_assign(std::string(token.key), std::string(token.value));
+        XINI_STATS(if (result.second) this->counters.inserted(IniEntryBytes(result.first->first, result.first->second)));
         return true;
     }
 
+    /**
+     * @brief Store a parsed key-value pair according to a duplicate policy other than IniDuplicateLastWins.
+     *
+     * With IniDuplicateKeepAll, the data map holds the last value and every value of a repeated key
+     * is kept, in order, in a vector of the side table. Keys that appear once have no side entry.
+     *
+     * @param section The current section.
+     * @param key The key of the pair.
+     * @param value The value of the pair.
+     */
+    void parse_duplicate(const std::string& section, std::string_view key, std::string_view value) {
+        auto& target = this->data[section];
+        auto keyIt = target.find(key);
+        if (keyIt == target.end()) {
+            [[maybe_unused]] auto result = target.emplace(std::string(key), std::string(value));
+            XINI_STATS(this->counters.inserted(IniEntryBytes(result.first->first, result.first->second)));
+            return;
+        }
+        if (this->syntax.duplicates == IniDuplicateFirstWins) {
+            return;
+        }
+
+        auto& values = this->repeated[section][keyIt->first];
+        if (values.empty()) {
+            values.push_back(keyIt->second);
+        }
+        values.emplace_back(value);
+        keyIt->second.assign(value);
+    }
+
+    /**
+     * @brief Forget the repeated values of a key, which now has a single value.
+     *
+     * @param section The section of the key.
+     * @param key The key.
+     */
+    void drop_values(std::string_view section, std::string_view key) {
+        if (this->repeated.empty()) {
+            return;
+        }
+        auto sectionIt = this->repeated.find(section);
+        if (sectionIt != this->repeated.end()) {
+            auto keyIt = sectionIt->second.find(key);
+            if (keyIt != sectionIt->second.end()) {
+                sectionIt->second.erase(keyIt);
+            }
+            if (sectionIt->second.empty()) {
+                this->repeated.erase(sectionIt);
+            }
+        }
+    }
+
+    /**
+     * @brief Forget the repeated values of every key of a section.
+     *
+     * @param section The section.
+     */
+    void drop_values(std::string_view section) {
+        if (this->repeated.empty()) {
+            return;
+        }
+        auto sectionIt = this->repeated.find(section);
+        if (sectionIt != this->repeated.end()) {
+            this->repeated.erase(sectionIt);
+        }
+    }
+
+    /**
+     * @brief Update the repeated values for a merge, before the data maps are merged.
+     *
+     * Keys whose value comes from the other parser take its repeated values, if any.
+     *
+     * @param other The parser that is about to be merged.
+     * @param policy The merge policy.
+     */
+    void merge_values(const IniParserA& other, IniMergePolicy policy) {
+        for (const auto& section : other.data) {
+            auto sectionIt = this->data.find(section.first);
+            auto otherIt = other.repeated.find(section.first);
+            for (const auto& pair : section.second) {
+                bool present = sectionIt != this->data.end() && sectionIt->second.find(pair.first) != sectionIt->second.end();
+                if (present && policy == IniMergeFirstWins) {
+                    continue;
+                }
+                this->drop_values(section.first, pair.first);
+                if (otherIt != other.repeated.end()) {
+                    auto valuesIt = otherIt->second.find(pair.first);
+                    if (valuesIt != otherIt->second.end()) {
+                        this->repeated[section.first][pair.first] = valuesIt->second;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Parse a stream line by line, also filling a diagnostics side table.
+     *
+     * Each line is checked by diagnose_line and then parsed by parse_line, exactly as in the regular
+     * parse, so both produce the same data. The regular parse loops do not go through this function.
+     *
+     * @param stream The stream to parse.
+     * @param diagnostics The side table to fill.
+     */
+    void parse_diagnosed(std::basic_istream<char>& stream, IniDiagnosticsA& diagnostics) {
+        std::string line;
+        std::string currentSection;
+        std::size_t lineNumber = 0;
+        while (std::getline(stream, line)) {
+            this->diagnose_line(currentSection, line, ++lineNumber, diagnostics);
+            this->parse_line(&currentSection, line);
+        }
+    }
+
+    /**
+     * @brief Report what parse_line is about to do with a line that is probably malformed.
+     *
+     * This function follows the same rules as parse_line and records the position of the key-value pair.
+     *
+     * @param currentSection The current section being parsed.
+     * @param line The line to check.
+     * @param lineNumber The number of the line, starting at 1.
+     * @param diagnostics The side table to fill.
+     */
+    void diagnose_line(const std::string& currentSection, const std::string& line, std::size_t lineNumber, IniDiagnosticsA& diagnostics) const {
+        auto token = IniTokenize(std::string_view(line), this->syntax);
+        if (token.kind == IniTokenEmpty) return;
+        if (!this->syntax.stripCarriageReturn && line.back() == '\r') {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticCarriageReturn, lineNumber, line.size(),
+                "Line ends with a carriage return, which is kept in the parsed text");
+        }
+        if (token.kind == IniTokenSection) return;
+
+        if (token.kind == IniTokenInvalid) {
+            size_t start = this->syntax.trim ? line.find_first_not_of(" \t") : 0;
+            if (line[start] == '[') {
+                diagnostics.report(IniDiagnosticError, IniDiagnosticUnterminatedSection, lineNumber, line.size(),
+                    "Section header does not end with ']'");
+            }
+            else {
+                diagnostics.report(IniDiagnosticError, IniDiagnosticMissingEquals, lineNumber, 1,
+                    "Line is not a comment, a section header or a key-value pair");
+            }
+            return;
+        }
+
+        if (token.key.size() > 0 && token.key[0] == '[') {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticUnterminatedSection, lineNumber, token.keyColumn,
+                "Line starting with '[' is parsed as a key-value pair");
+        }
+        if (token.key.empty()) {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticEmptyKey, lineNumber, token.keyColumn, "Key is empty");
+        }
+        else if (IniIsBlank(token.key.front()) || IniIsBlank(token.key.back())) {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticKeyWhitespace, lineNumber, token.keyColumn,
+                "Key starts or ends with a blank, which is kept in the key");
+        }
+
+        std::string key(token.key);
+        auto sectionIt = this->data.find(currentSection);
+        bool duplicate = sectionIt != this->data.end() && sectionIt->second.find(key) != sectionIt->second.end();
+        if (this->syntax.duplicates != IniDuplicateKeepAll && duplicate) {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticDuplicateKey, lineNumber, token.keyColumn,
+                this->syntax.duplicates == IniDuplicateFirstWins ? "Key is already defined in this section; the first value wins"
+                                                                 : "Key is already defined in this section; the last value wins");
+        }
+        // The position is the one of the line the value comes from, which an ignored duplicate is not.
+        if (!(duplicate && this->syntax.duplicates == IniDuplicateFirstWins)) {
+            diagnostics.locate(currentSection, key, lineNumber, token.valueColumn);
+        }
+    }
+
     /**
      * @brief Parse the contents of an INI file.
      *
@@ -92,10 +366,18 @@ private:
      * pairs in the data map.
      *
      * @param content The content of the INI file.
+     * @param diagnostics The side table to fill with diagnostics and positions, or nullptr for the regular parse.
      */
-    void parse_raw(const std::string& content) {
+    void parse_raw(const std::string& content, IniDiagnosticsA* diagnostics = nullptr) {
+        XINI_STATS(IniStatsScope timer(this->counters.parseDuration));
+
         std::istringstream stringStream(content);
 
+        if (diagnostics != nullptr) {
+            this->parse_diagnosed(stringStream, *diagnostics);
+            return;
+        }
+
         std::string line;
         std::string currentSection;
         while (std::getline(stringStream, line)) {
@@ -115,15 +397,23 @@ private:
      * This function parses an INI file and stores the key-value pairs in the data map.
      *
      * @param filename The name of the INI file to parse.
+     * @param diagnostics The side table to fill with diagnostics and positions, or nullptr for the regular parse.
      * @return True if the file was successfully parsed, false otherwise.
      */
-    bool parse_file(const std::string& filename) {
+    bool parse_file(const std::string& filename, IniDiagnosticsA* diagnostics = nullptr) {
+        XINI_STATS(IniStatsScope timer(this->counters.parseDuration));
+
         std::ifstream file(filename);
         if (!file.is_open()) {
             //std::cerr << "Error: failed to open file " << filename << std::endl;
             return false;
         }
 
+        if (diagnostics != nullptr) {
+            this->parse_diagnosed(file, *diagnostics);
+            return true;
+        }
+
         std::string line;
         std::string currentSection;
         while (std::getline(file, line)) {
@@ -145,14 +435,16 @@ private:
      * @param key The key of the key-value pair.
      * @return The value of the key-value pair, or an empty string if the key does not exist.
      */
-    std::string getValue(const std::string& section, const std::string& key) const {
+    std::string getValue(std::string_view section, std::string_view key) const {
         auto sectionIt = data.find(section);
         if (sectionIt != data.end()) {
             auto keyIt = sectionIt->second.find(key);
             if (keyIt != sectionIt->second.end()) {
+                XINI_STATS(this->counters.looked_up(true));
                 return keyIt->second;
             }
         }
+        XINI_STATS(this->counters.looked_up(false));
         return "";
     }
 
@@ -165,8 +457,108 @@ private:
      * @param key The key of the key-value pair.
      * @param value The value to set.
      */
-    void setValue(const std::string& section, const std::string& key, const std::string& value) {
-        data[section][key] = value;
+    void setValue(std::string_view section, std::string_view key, std::string value) {
+        this->drop_values(section, key);
+        this->set_in_section(this->section_at(section), key, std::move(value));
+    }
+
+    /**
+     * @brief Set the value of a key in the map of a section, copying the key only if it is inserted.
+     *
+     * @param target The keys of the section.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    void set_in_section(section_type& target, std::string_view key, std::string value) {
+        auto keyIt = target.lower_bound(key);
+        if (keyIt != target.end() && std::string_view(keyIt->first) == key) {
+            keyIt->second = std::move(value);
+            return;
+        }
+        [[maybe_unused]] auto result = target.emplace_hint(keyIt, std::string(key), std::move(value));
+        XINI_STATS(this->counters.inserted(IniEntryBytes(result->first, result->second)));
+    }
+
+    /**
+     * @brief Count, in the statistics, the keys of a section that a merge adds to this parser.
+     *
+     * @param target The keys this parser has in the section, or nullptr if it does not have the section.
+     * @param incoming The keys of the section in the merged parser.
+     */
+    void count_merged([[maybe_unused]] const section_type* target, [[maybe_unused]] const section_type& incoming) {
+#if defined(XINI_ENABLE_STATS)
+        for (const auto& pair : incoming) {
+            if (!target || target->find(pair.first) == target->end()) {
+                this->counters.inserted(IniEntryBytes(pair.first, pair.second));
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Get a section, creating it if it does not exist.
+     *
+     * Unlike data[section], the name of the section is only copied when the section is created.
+     *
+     * @param section The name of the section.
+     * @return The keys of the section.
+     */
+    section_type& section_at(std::string_view section) {
+        auto sectionIt = this->data.lower_bound(section);
+        if (sectionIt == this->data.end() || std::string_view(sectionIt->first) != section) {
+            sectionIt = this->data.emplace_hint(sectionIt, std::string(section), section_type());
+        }
+        return sectionIt->second;
+    }
+
+    /**
+     * @brief Convert a value to its string representation.
+     *
+     * Strings and string views are copied as they are. Arithmetic types other than bool and character
+     * types are formatted with std::to_chars into a stack buffer, which is locale-independent and gives the
+     * shortest representation that round-trips for floating-point values. Anything else goes through a string stream.
+     *
+     * @param value The value to convert.
+     * @return The string representation of the value.
+     */
+    template <typename __T__>
+    static std::string format_value(const __T__& value) {
+        if constexpr (std::is_convertible_v<const __T__&, std::string_view>) {
+            return std::string(std::string_view(value));
+        }
+        else if constexpr (std::is_arithmetic_v<__T__> && !std::is_same_v<__T__, bool> &&
+            !std::is_same_v<__T__, char> && !std::is_same_v<__T__, signed char> && !std::is_same_v<__T__, unsigned char> &&
+            !std::is_same_v<__T__, wchar_t> && !std::is_same_v<__T__, char16_t> && !std::is_same_v<__T__, char32_t>) {
+            char buffer[64];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return std::string(buffer, result.ptr);
+        }
+        else {
+            std::ostringstream oss;
+            oss << value;
+            return oss.str();
+        }
+    }
+
+    /**
+     * @brief Check that no key of another parser conflicts with this one.
+     *
+     * @param other The parser that is about to be merged.
+     * @throws std::runtime_error If a key is defined by both parsers with different values.
+     */
+    void check_conflicts(const IniParserA& other) const {
+        for (const auto& section : other.data) {
+            auto sectionIt = this->data.find(section.first);
+            if (sectionIt == this->data.end()) {
+                continue;
+            }
+            for (const auto& pair : section.second) {
+                auto keyIt = sectionIt->second.find(pair.first);
+                if (keyIt != sectionIt->second.end() && keyIt->second != pair.second) {
+                    throw std::runtime_error("Conflicting values for the same key in merged parsers");
+                }
+            }
+        }
     }
 
 public:
@@ -180,6 +572,8 @@ public:
      * @return True if the file was successfully written, false otherwise.
      */
     bool commit(const char* filename) {
+        XINI_STATS(IniStatsScope timer(this->counters.commitDuration));
+
         std::ofstream file(filename);
         if (!file.is_open()) {
             //std::cerr << "Error: failed to open file " << filename << " for writing" << std::endl;
@@ -188,9 +582,19 @@ public:
 
         // Write sections and key-value pairs to file
         for (const auto& section : data) {
-            file << "[" << section.first << "]" << std::endl;
+            file << "[" << section.first << "]" << '\n';
+            auto repeatedIt = this->repeated.find(section.first);
             for (const auto& pair : section.second) {
-                file << pair.first << "=" << pair.second << std::endl;
+                if (repeatedIt != this->repeated.end()) {
+                    auto valuesIt = repeatedIt->second.find(pair.first);
+                    if (valuesIt != repeatedIt->second.end()) {
+                        for (const auto& value : valuesIt->second) {
+                            file << pair.first << "=" << value << '\n';
+                        }
+                        continue;
+                    }
+                }
+                file << pair.first << "=" << pair.second << '\n';
             }
         }
 
@@ -221,6 +625,82 @@ public:
         this->parse_raw(content);
     }
 
+    /**
+     * @brief Parse an INI file, reporting malformed lines and the position of every key-value pair.
+     *
+     * The file is parsed exactly as operator>> does. Lines that operator>> silently ignores or keeps
+     * in a surprising form are reported as errors or warnings in the side table.
+     *
+     * @param filename The name of the INI file to parse.
+     * @param diagnostics The side table to fill. Previous diagnostics are kept.
+     * @return True if the file was successfully parsed, false otherwise.
+     */
+    bool load(const char* filename, IniDiagnosticsA& diagnostics) {
+        return this->parse_file(filename, &diagnostics);
+    }
+
+    /**
+     * @brief Parse INI content, reporting malformed lines and the position of every key-value pair.
+     *
+     * @param content The content of the INI file.
+     * @param diagnostics The side table to fill. Previous diagnostics are kept.
+     */
+    void load_string(const char* content, IniDiagnosticsA& diagnostics) {
+        this->parse_raw(content, &diagnostics);
+    }
+
+    /**
+     * @brief Parse a chunk of INI content, for example as it arrives from a pipe or a socket.
+     *
+     * Complete lines are parsed straight from the chunk. A line split across chunks is kept in a carry buffer,
+     * which only ever holds the unfinished line, and is parsed when its end arrives. The content
+     * does not have to be NUL-terminated. Call finish() after the last chunk.
+     *
+     * @param content The chunk.
+     * @param length The number of characters of the chunk.
+     */
+    void feed(const char* content, std::size_t length) {
+        const char* end = content + length;
+        while (content != end) {
+            const char* newline = std::char_traits<char>::find(content, static_cast<std::size_t>(end - content), '\n');
+            if (newline == nullptr) {
+                this->carry.append(content, end);
+                return;
+            }
+            if (this->carry.empty()) {
+                this->parse_line(&this->carrySection, std::string_view(content, static_cast<std::size_t>(newline - content)));
+            }
+            else {
+                this->carry.append(content, newline);
+                this->parse_line(&this->carrySection, this->carry);
+                this->carry.clear();
+            }
+            content = newline + 1;
+        }
+    }
+
+    /**
+     * @brief Parse a chunk of INI content.
+     *
+     * @param content The chunk.
+     */
+    void feed(std::string_view content) {
+        this->feed(content.data(), content.size());
+    }
+
+    /**
+     * @brief Parse the last line fed, if it did not end with a newline, and reset the feed state.
+     *
+     * The next chunk fed starts a new content, outside of any section.
+     */
+    void finish() {
+        if (!this->carry.empty()) {
+            this->parse_line(&this->carrySection, this->carry);
+        }
+        this->carry.clear();
+        this->carrySection.clear();
+    }
+
     /**
      * @brief Get the value of a key in a section.
      *
@@ -231,7 +711,7 @@ public:
      * @return The value of the key-value pair, or an empty string if the key does not exist.
      */
     template<typename __T__ = IniString>
-    __T__ get(const char* section, const char* var) {
+    __T__ get(std::string_view section, std::string_view var) {
         return static_cast<__T__>(this->getValue(section, var));
     }
 
@@ -246,13 +726,58 @@ public:
      */
     template <typename __T__ = IniString>
     void set(const char* section, const char* var, const __T__& value) {
+        this->setValue(section, var, format_value(value));
+    }
+
+    /**
+     * @brief Set the value of a key in a section, taking ownership of the string.
+     *
+     * This function moves the string into the data map without copying it.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    void set(const char* section, const char* var, std::string&& value) {
+        this->setValue(section, var, std::move(value));
+    }
 
-        std::ostringstream oss;
-        oss << value;
+    /**
+     * @brief Set many keys of one section.
+     *
+     * This function looks the section up once and then inserts every key-value pair of the range,
+     * for example a std::vector or std::map of pairs. Values are converted like set() does. If the
+     * range is passed as an rvalue, string values are moved rather than copied.
+     *
+     * @param section The section of the key-value pairs.
+     * @param pairs The range of key-value pairs.
+     */
+    template <typename Range>
+    void set_many(const char* section, Range&& pairs) {
+        auto& target = this->section_at(section);
+        for (auto&& pair : pairs) {
+            std::string_view key(pair.first);
+            this->drop_values(section, key);
+            if constexpr (!std::is_lvalue_reference_v<Range> && std::is_same_v<std::decay_t<decltype(pair.second)>, std::string>) {
+                this->set_in_section(target, key, std::move(pair.second));
+            }
+            else {
+                this->set_in_section(target, key, format_value(pair.second));
+            }
+        }
+    }
 
-        this->setValue(section, var, oss.str());
+    /**
+     * @brief Set many keys of one section.
+     *
+     * @param section The section of the key-value pairs.
+     * @param pairs The key-value pairs, for example {{"host", "localhost"}, {"port", "5432"}}.
+     */
+    void set_many(const char* section, std::initializer_list<std::pair<std::string_view, std::string_view>> pairs) {
+        this->set_many<const std::initializer_list<std::pair<std::string_view, std::string_view>>&>(section, pairs);
     }
 
+
     /**
      * @brief Check if a key exists in a section.
      *
@@ -262,8 +787,9 @@ public:
      * @param key The key of the key-value pair.
      * @return True if the key exists, false otherwise.
      */
-    bool exist(const char* section, const char* var) {
-        return !getValue(section, var).empty();
+    bool exist(std::string_view section, std::string_view var) const {
+        const std::string* value = this->lookup(section, var);
+        return value != nullptr && !value->empty();
     }
 
     /**
@@ -274,7 +800,7 @@ public:
      * @param section The section to check.
      * @return True if the section exists, false otherwise.
      */
-    bool exist(const char* section) const {
+    bool exist(std::string_view section) const {
         return data.find(section) != data.end();
     }
 
@@ -286,8 +812,16 @@ public:
      * @param section The section of the key-value pair.
      * @param key The key of the key-value pair to delete.
      */
-    void rem(const char* section, const char* key) {
-        data[section].erase(key);
+    void rem(std::string_view section, std::string_view key) {
+        this->drop_values(section, key);
+        auto sectionIt = this->data.find(section);
+        if (sectionIt == this->data.end()) {
+            return;
+        }
+        auto keyIt = sectionIt->second.find(key);
+        if (keyIt != sectionIt->second.end()) {
+            sectionIt->second.erase(keyIt);
+        }
     }
 
     /**
@@ -297,8 +831,12 @@ public:
      *
      * @param section The section to delete.
      */
-    void rem(const char* section) {
-        data.erase(section);
+    void rem(std::string_view section) {
+        this->drop_values(section);
+        auto sectionIt = this->data.find(section);
+        if (sectionIt != this->data.end()) {
+            this->data.erase(sectionIt);
+        }
     }
 
     /**
@@ -309,9 +847,70 @@ public:
      * @return The current data map.
      */
     std::map<std::string, std::map<std::string, std::string>> map() {
+        std::map<std::string, std::map<std::string, std::string>> result;
+        for (const auto& section : this->data) {
+            result.emplace_hint(result.end(), section.first, std::map<std::string, std::string>(section.second.begin(), section.second.end()));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get a read-only reference to the data map.
+     *
+     * Unlike map(), this function does not copy the data. The referenced sections and values
+     * may be changed or removed by any function that modifies the parser.
+     *
+     * @return A const reference to the current data map.
+     */
+    const data_type& view() const {
         return this->data;
     }
 
+    /**
+     * @brief Find the value of a key in a section without copying it.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return A pointer to the stored value, or nullptr if the key does not exist. The pointer is
+     *         invalidated when the key or its section is removed.
+     */
+    const std::string* lookup(std::string_view section, std::string_view key) const {
+        auto sectionIt = this->data.find(section);
+        if (sectionIt == this->data.end()) {
+            XINI_STATS(this->counters.looked_up(false));
+            return nullptr;
+        }
+        auto keyIt = sectionIt->second.find(key);
+        XINI_STATS(this->counters.looked_up(keyIt != sectionIt->second.end()));
+        return keyIt != sectionIt->second.end() ? &keyIt->second : nullptr;
+    }
+
+    /**
+     * @brief Get every value of a key.
+     *
+     * When the parser reads repeated keys with IniDuplicateKeepAll, this returns all their values in the
+     * order of the lines. Otherwise, and for keys that appear once, it returns the single value of the key.
+     * Iterating the range does not allocate. Setting or removing the key drops its repeated values.
+     *
+     * @param section The section of the key.
+     * @param key The key.
+     * @return The values of the key, or an empty range if the key does not exist.
+     */
+    IniValueRange<std::string> values(std::string_view section, std::string_view key) const {
+        if (!this->repeated.empty()) {
+            auto sectionIt = this->repeated.find(section);
+            if (sectionIt != this->repeated.end()) {
+                auto keyIt = sectionIt->second.find(key);
+                if (keyIt != sectionIt->second.end()) {
+                    const std::string* first = keyIt->second.data();
+                    return { first, first + keyIt->second.size() };
+                }
+            }
+        }
+        const std::string* value = this->lookup(section, key);
+        return { value, value != nullptr ? value + 1 : nullptr };
+    }
+
     /**
      * @brief Conversion operator to IniMap (std::map<std::string, std::map<std::string, std::string>>).
      *
@@ -345,22 +944,237 @@ public:
      * @param map The map containing the data to be loaded.
      */
     void loadmap(const std::map <std::string, std::map<std::string, std::string>>& map) {
-        this->data = map;
+        data_type loaded;
+        for (const auto& section : map) {
+            loaded.emplace_hint(loaded.end(), section.first, section_type(section.second.begin(), section.second.end()));
+        }
+        this->data.swap(loaded);
+        this->repeated.clear();
     }
 
-private:
-    std::map<std::string, std::map<std::string, std::string>> data;
-};
-
-/**
- * @brief A simple INI file parser class. <WIDE>
- */
-class IniParserW {
-public:
     /**
-     * @brief Default constructor.
+     * @brief Load data from a map with transparent comparators, such as the one returned by view().
+     *
+     * @param map The map containing the data to be loaded.
      */
-    IniParserW() {}
+    void loadmap(const data_type& map) {
+        this->data = map;
+        this->repeated.clear();
+    }
+
+    /**
+     * @brief Merge the data of another parser into this one.
+     *
+     * This function copies the sections and key-value pairs of another parser into this one.
+     * Sections missing from this parser are copied as a whole; keys defined by both parsers are
+     * resolved according to the merge policy. With IniMergeError, conflicts are checked before
+     * anything is copied, so a failed merge leaves this parser unchanged.
+     *
+     * @param other The parser to merge from.
+     * @param policy The policy applied to keys defined by both parsers.
+     * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
+     */
+    void merge(const IniParserA& other, IniMergePolicy policy = IniMergeLastWins) {
+        if (policy == IniMergeError) {
+            this->check_conflicts(other);
+        }
+        if (!this->repeated.empty() || !other.repeated.empty()) {
+            this->merge_values(other, policy);
+        }
+
+        // Both maps are sorted, so a single forward walk over this parser finds every insertion point,
+        // and each missing entry is inserted right before the cursor.
+        auto sectionLess = this->data.key_comp();
+        auto sectionIt = this->data.begin();
+        for (const auto& section : other.data) {
+            while (sectionIt != this->data.end() && sectionLess(sectionIt->first, section.first)) {
+                ++sectionIt;
+            }
+            if (sectionIt == this->data.end() || sectionLess(section.first, sectionIt->first)) {
+                this->data.emplace_hint(sectionIt, section);
+                XINI_STATS(this->count_merged(nullptr, section.second));
+                continue;
+            }
+
+            auto& target = sectionIt->second;
+            auto keyLess = target.key_comp();
+            auto keyIt = target.begin();
+            for (const auto& pair : section.second) {
+                while (keyIt != target.end() && keyLess(keyIt->first, pair.first)) {
+                    ++keyIt;
+                }
+                if (keyIt == target.end() || keyLess(pair.first, keyIt->first)) {
+                    target.emplace_hint(keyIt, pair);
+                    XINI_STATS(this->counters.inserted(IniEntryBytes(pair.first, pair.second)));
+                }
+                else if (policy == IniMergeLastWins) {
+                    keyIt->second = pair.second;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Merge the data of another parser into this one, taking ownership of it.
+     *
+     * This function moves the sections and key-value pairs of another parser into this one.
+     * Map nodes are spliced rather than copied: a section missing from this parser is transferred
+     * as a whole, and keys of a shared section are transferred one node at a time. Keys defined
+     * by both parsers are resolved according to the merge policy. The other parser is left empty.
+     *
+     * @param other The parser to merge from.
+     * @param policy The policy applied to keys defined by both parsers.
+     * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
+     */
+    void merge(IniParserA&& other, IniMergePolicy policy = IniMergeLastWins) {
+        if (policy == IniMergeError) {
+            this->check_conflicts(other);
+        }
+        if (!this->repeated.empty() || !other.repeated.empty()) {
+            this->merge_values(other, policy);
+            other.repeated.clear();
+        }
+
+        if (this->data.empty()) {
+            this->data.swap(other.data);
+            XINI_STATS(for (const auto& section : this->data) this->count_merged(nullptr, section.second));
+            return;
+        }
+
+        for (auto it = other.data.begin(); it != other.data.end();) {
+            auto next = std::next(it);
+            auto sectionIt = this->data.lower_bound(it->first);
+            XINI_STATS(this->count_merged(sectionIt == this->data.end() || sectionIt->first != it->first ? nullptr : &sectionIt->second, it->second));
+
+            if (sectionIt == this->data.end() || sectionIt->first != it->first) {
+                this->data.insert(sectionIt, other.data.extract(it));
+            }
+            else if (policy == IniMergeLastWins) {
+                // Splice the missing keys into the incoming section, so its values win, then adopt it.
+                it->second.merge(sectionIt->second);
+                sectionIt->second.swap(it->second);
+            }
+            else {
+                sectionIt->second.merge(it->second);
+            }
+
+            it = next;
+        }
+
+        other.data.clear();
+    }
+
+    /**
+     * @brief Get the instrumentation counters of the parser.
+     *
+     * The counters are only maintained when the library is compiled with XINI_ENABLE_STATS.
+     * Otherwise, every field of the result is 0 and the parser does not pay for them.
+     *
+     * @return A snapshot of the counters. Use IniStatsToPrometheus to export it.
+     */
+    IniStats stats() const {
+#if defined(XINI_ENABLE_STATS)
+        return this->counters.snapshot();
+#else
+        return IniStats();
+#endif
+    }
+
+    /**
+     * @brief Reset the instrumentation counters of the parser to 0.
+     */
+    void reset_stats() {
+        XINI_STATS(this->counters.reset());
+    }
+
+    /**
+     * @brief Get the dialect of the INI syntax read by the parser.
+     *
+     * @return The syntax options.
+     */
+    const IniDialect& dialect() const {
+        return this->syntax;
+    }
+
+    /**
+     * @brief Change the dialect of the INI syntax read by the parser.
+     *
+     * Only the content parsed from now on is affected.
+     *
+     * @param dialect The syntax options, for example IniDialect::relaxed().
+     */
+    void set_dialect(const IniDialect& dialect) {
+        this->syntax = dialect;
+    }
+
+private:
+    template <typename Parser>
+    friend class IniBasicTransaction;
+
+    template <typename Parser>
+    friend class IniBasicJournal;
+
+    template <typename Parser>
+    friend class IniBasicParallelWriter;
+
+    data_type data;
+    IniDialect syntax;
+
+    /**
+     * @brief The unfinished line and the current section of the content passed to feed().
+     */
+    std::string carry;
+    std::string carrySection;
+
+    /**
+     * @brief Every value of the keys read more than once with IniDuplicateKeepAll, by section and key.
+     */
+    std::map<std::string, std::map<std::string, std::vector<std::string>, std::less<>>, std::less<>> repeated;
+
+#if defined(XINI_ENABLE_STATS)
+    mutable IniStatsCounters counters;
+#endif
+};
+
+/**
+ * @brief A simple INI file parser class. <WIDE>
+ */
+class IniParserW {
+public:
+    /**
+     * @brief Default constructor.
+     */
+    IniParserW() {}
+
+    /**
+     * @brief Create a parser reading a dialect of the INI syntax.
+     *
+     * @param dialect The syntax options, for example IniDialect::relaxed().
+     */
+    explicit IniParserW(const IniDialect& dialect) : syntax(dialect) {}
+
+    /**
+     * @brief Character type of the sections, keys and values.
+     */
+    typedef wchar_t char_type;
+
+    /**
+     * @brief String type of the sections, keys and values.
+     */
+    typedef std::wstring string_type;
+
+    /**
+     * @brief Map of the keys of a section to their values.
+     *
+     * The comparator is transparent, so keys can be looked up with a std::wstring_view or a wchar_t pointer
+     * without building a temporary std::wstring.
+     */
+    typedef std::map<std::wstring, std::wstring, std::less<>> section_type;
+
+    /**
+     * @brief Map of the sections to their keys, with a transparent comparator like section_type.
+     */
+    typedef std::map<std::wstring, section_type, std::less<>> data_type;
 
 private:
 
@@ -371,25 +1185,200 @@ private:
      * of an INI file and stores them in the data map.
      *
      * @param currentSection The current section being parsed.
-     * @param line The line to parse.
+     * @param line The line to parse, without its newline.
      * @return True if the line was successfully parsed, false otherwise.
      */
-    bool parse_line(std::wstring* currentSection, const std::wstring& line) {
-        if (line.empty() || line[0] == L';') return false;
-        if (line[0] == L'[' && line.back() == L']') {
-            *currentSection = line.substr(1, line.size() - 2);
+    bool parse_line(std::wstring* currentSection, std::wstring_view line) {
+        XINI_STATS(this->counters.parsed_line((line.size() + 1) * sizeof(wchar_t)));
+
+        auto token = IniTokenize(line, this->syntax);
+        if (token.kind == IniTokenSection) {
+            currentSection->assign(token.section);
             return false;
         }
+        if (token.kind != IniTokenPair) return false;
+        if (this->syntax.duplicates != IniDuplicateLastWins) {
+            this->parse_duplicate(*currentSection, token.key, token.value);
+            return true;
+        }
 
-        size_t equalPos = line.find(L'=');
-        if (equalPos == std::wstring::npos) return false;
-
-        std::wstring key = line.substr(0, equalPos);
-        std::wstring value = line.substr(equalPos + 1);
-        data[*currentSection][key] = value;
+        [[maybe_unused]] auto result = data[*currentSection].insert_or_assign(std::wstring(token.key), std::wstring(token.value));
+        XINI_STATS(if (result.second) this->counters.inserted(IniEntryBytes(result.first->first, result.first->second)));
         return true;
     }
 
+    /**
+     * @brief Store a parsed key-value pair according to a duplicate policy other than IniDuplicateLastWins.
+     *
+     * With IniDuplicateKeepAll, the data map holds the last value and every value of a repeated key
+     * is kept, in order, in a vector of the side table. Keys that appear once have no side entry.
+     *
+     * @param section The current section.
+     * @param key The key of the pair.
+     * @param value The value of the pair.
+     */
+    void parse_duplicate(const std::wstring& section, std::wstring_view key, std::wstring_view value) {
+        auto& target = this->data[section];
+        auto keyIt = target.find(key);
+        if (keyIt == target.end()) {
+            [[maybe_unused]] auto result = target.emplace(std::wstring(key), std::wstring(value));
+            XINI_STATS(this->counters.inserted(IniEntryBytes(result.first->first, result.first->second)));
+            return;
+        }
+        if (this->syntax.duplicates == IniDuplicateFirstWins) {
+            return;
+        }
+
+        auto& values = this->repeated[section][keyIt->first];
+        if (values.empty()) {
+            values.push_back(keyIt->second);
+        }
+        values.emplace_back(value);
+        keyIt->second.assign(value);
+    }
+
+    /**
+     * @brief Forget the repeated values of a key, which now has a single value.
+     *
+     * @param section The section of the key.
+     * @param key The key.
+     */
+    void drop_values(std::wstring_view section, std::wstring_view key) {
+        if (this->repeated.empty()) {
+            return;
+        }
+        auto sectionIt = this->repeated.find(section);
+        if (sectionIt != this->repeated.end()) {
+            auto keyIt = sectionIt->second.find(key);
+            if (keyIt != sectionIt->second.end()) {
+                sectionIt->second.erase(keyIt);
+            }
+            if (sectionIt->second.empty()) {
+                this->repeated.erase(sectionIt);
+            }
+        }
+    }
+
+    /**
+     * @brief Forget the repeated values of every key of a section.
+     *
+     * @param section The section.
+     */
+    void drop_values(std::wstring_view section) {
+        if (this->repeated.empty()) {
+            return;
+        }
+        auto sectionIt = this->repeated.find(section);
+        if (sectionIt != this->repeated.end()) {
+            this->repeated.erase(sectionIt);
+        }
+    }
+
+    /**
+     * @brief Update the repeated values for a merge, before the data maps are merged.
+     *
+     * Keys whose value comes from the other parser take its repeated values, if any.
+     *
+     * @param other The parser that is about to be merged.
+     * @param policy The merge policy.
+     */
+    void merge_values(const IniParserW& other, IniMergePolicy policy) {
+        for (const auto& section : other.data) {
+            auto sectionIt = this->data.find(section.first);
+            auto otherIt = other.repeated.find(section.first);
+            for (const auto& pair : section.second) {
+                bool present = sectionIt != this->data.end() && sectionIt->second.find(pair.first) != sectionIt->second.end();
+                if (present && policy == IniMergeFirstWins) {
+                    continue;
+                }
+                this->drop_values(section.first, pair.first);
+                if (otherIt != other.repeated.end()) {
+                    auto valuesIt = otherIt->second.find(pair.first);
+                    if (valuesIt != otherIt->second.end()) {
+                        this->repeated[section.first][pair.first] = valuesIt->second;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Parse a stream line by line, also filling a diagnostics side table.
+     *
+     * Each line is checked by diagnose_line and then parsed by parse_line, exactly as in the regular
+     * parse, so both produce the same data. The regular parse loops do not go through this function.
+     *
+     * @param stream The stream to parse.
+     * @param diagnostics The side table to fill.
+     */
+    void parse_diagnosed(std::basic_istream<wchar_t>& stream, IniDiagnosticsW& diagnostics) {
+        std::wstring line;
+        std::wstring currentSection;
+        std::size_t lineNumber = 0;
+        while (std::getline(stream, line)) {
+            this->diagnose_line(currentSection, line, ++lineNumber, diagnostics);
+            this->parse_line(&currentSection, line);
+        }
+    }
+
+    /**
+     * @brief Report what parse_line is about to do with a line that is probably malformed.
+     *
+     * This function follows the same rules as parse_line and records the position of the key-value pair.
+     *
+     * @param currentSection The current section being parsed.
+     * @param line The line to check.
+     * @param lineNumber The number of the line, starting at 1.
+     * @param diagnostics The side table to fill.
+     */
+    void diagnose_line(const std::wstring& currentSection, const std::wstring& line, std::size_t lineNumber, IniDiagnosticsW& diagnostics) const {
+        auto token = IniTokenize(std::wstring_view(line), this->syntax);
+        if (token.kind == IniTokenEmpty) return;
+        if (!this->syntax.stripCarriageReturn && line.back() == L'\r') {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticCarriageReturn, lineNumber, line.size(),
+                "Line ends with a carriage return, which is kept in the parsed text");
+        }
+        if (token.kind == IniTokenSection) return;
+
+        if (token.kind == IniTokenInvalid) {
+            size_t start = this->syntax.trim ? line.find_first_not_of(L" \t") : 0;
+            if (line[start] == L'[') {
+                diagnostics.report(IniDiagnosticError, IniDiagnosticUnterminatedSection, lineNumber, line.size(),
+                    "Section header does not end with ']'");
+            }
+            else {
+                diagnostics.report(IniDiagnosticError, IniDiagnosticMissingEquals, lineNumber, 1,
+                    "Line is not a comment, a section header or a key-value pair");
+            }
+            return;
+        }
+
+        if (token.key.size() > 0 && token.key[0] == L'[') {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticUnterminatedSection, lineNumber, token.keyColumn,
+                "Line starting with '[' is parsed as a key-value pair");
+        }
+        if (token.key.empty()) {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticEmptyKey, lineNumber, token.keyColumn, "Key is empty");
+        }
+        else if (IniIsBlank(token.key.front()) || IniIsBlank(token.key.back())) {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticKeyWhitespace, lineNumber, token.keyColumn,
+                "Key starts or ends with a blank, which is kept in the key");
+        }
+
+        std::wstring key(token.key);
+        auto sectionIt = this->data.find(currentSection);
+        bool duplicate = sectionIt != this->data.end() && sectionIt->second.find(key) != sectionIt->second.end();
+        if (this->syntax.duplicates != IniDuplicateKeepAll && duplicate) {
+            diagnostics.report(IniDiagnosticWarning, IniDiagnosticDuplicateKey, lineNumber, token.keyColumn,
+                this->syntax.duplicates == IniDuplicateFirstWins ? "Key is already defined in this section; the first value wins"
+                                                                 : "Key is already defined in this section; the last value wins");
+        }
+        // The position is the one of the line the value comes from, which an ignored duplicate is not.
+        if (!(duplicate && this->syntax.duplicates == IniDuplicateFirstWins)) {
+            diagnostics.locate(currentSection, key, lineNumber, token.valueColumn);
+        }
+    }
+
     /**
      * @brief Parse the contents of an INI file.
      *
@@ -397,10 +1386,18 @@ private:
      * pairs in the data map.
      *
      * @param content The content of the INI file.
+     * @param diagnostics The side table to fill with diagnostics and positions, or nullptr for the regular parse.
      */
-    void parse_raw(const std::wstring& content) {
+    void parse_raw(const std::wstring& content, IniDiagnosticsW* diagnostics = nullptr) {
+        XINI_STATS(IniStatsScope timer(this->counters.parseDuration));
+
         std::wistringstream stringStream(content);
 
+        if (diagnostics != nullptr) {
+            this->parse_diagnosed(stringStream, *diagnostics);
+            return;
+        }
+
         std::wstring line;
         std::wstring currentSection;
         while (std::getline(stringStream, line)) {
@@ -416,15 +1413,23 @@ private:
      * This function parses an INI file and stores the key-value pairs in the data map.
      *
      * @param filename The name of the INI file to parse.
+     * @param diagnostics The side table to fill with diagnostics and positions, or nullptr for the regular parse.
      * @return True if the file was successfully parsed, false otherwise.
      */
-    bool parse_file(const std::wstring& filename) {
-        std::wifstream file(filename);
+    bool parse_file(const std::wstring& filename, IniDiagnosticsW* diagnostics = nullptr) {
+        XINI_STATS(IniStatsScope timer(this->counters.parseDuration));
+
+        std::wifstream file{ std::filesystem::path(filename) };
         if (!file.is_open()) {
             //std::wcerr << L"Error: failed to open file " << filename << std::endl;
             return false;
         }
 
+        if (diagnostics != nullptr) {
+            this->parse_diagnosed(file, *diagnostics);
+            return true;
+        }
+
         std::wstring line;
         std::wstring currentSection;
         while (std::getline(file, line)) {
@@ -446,14 +1451,16 @@ private:
      * @param key The key of the key-value pair.
      * @return The value of the key-value pair, or an empty string if the key does not exist.
      */
-    std::wstring getValue(const std::wstring& section, const std::wstring& key) const {
+    std::wstring getValue(std::wstring_view section, std::wstring_view key) const {
         auto sectionIt = data.find(section);
         if (sectionIt != data.end()) {
             auto keyIt = sectionIt->second.find(key);
             if (keyIt != sectionIt->second.end()) {
+                XINI_STATS(this->counters.looked_up(true));
                 return keyIt->second;
             }
         }
+        XINI_STATS(this->counters.looked_up(false));
         return L"";
     }
 
@@ -466,8 +1473,108 @@ private:
      * @param key The key of the key-value pair.
      * @param value The value to set.
      */
-    void setValue(const std::wstring& section, const std::wstring& key, const std::wstring& value) {
-        data[section][key] = value;
+    void setValue(std::wstring_view section, std::wstring_view key, std::wstring value) {
+        this->drop_values(section, key);
+        this->set_in_section(this->section_at(section), key, std::move(value));
+    }
+
+    /**
+     * @brief Set the value of a key in the map of a section, copying the key only if it is inserted.
+     *
+     * @param target The keys of the section.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    void set_in_section(section_type& target, std::wstring_view key, std::wstring value) {
+        auto keyIt = target.lower_bound(key);
+        if (keyIt != target.end() && std::wstring_view(keyIt->first) == key) {
+            keyIt->second = std::move(value);
+            return;
+        }
+        [[maybe_unused]] auto result = target.emplace_hint(keyIt, std::wstring(key), std::move(value));
+        XINI_STATS(this->counters.inserted(IniEntryBytes(result->first, result->second)));
+    }
+
+    /**
+     * @brief Count, in the statistics, the keys of a section that a merge adds to this parser.
+     *
+     * @param target The keys this parser has in the section, or nullptr if it does not have the section.
+     * @param incoming The keys of the section in the merged parser.
+     */
+    void count_merged([[maybe_unused]] const section_type* target, [[maybe_unused]] const section_type& incoming) {
+#if defined(XINI_ENABLE_STATS)
+        for (const auto& pair : incoming) {
+            if (!target || target->find(pair.first) == target->end()) {
+                this->counters.inserted(IniEntryBytes(pair.first, pair.second));
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Get a section, creating it if it does not exist.
+     *
+     * Unlike data[section], the name of the section is only copied when the section is created.
+     *
+     * @param section The name of the section.
+     * @return The keys of the section.
+     */
+    section_type& section_at(std::wstring_view section) {
+        auto sectionIt = this->data.lower_bound(section);
+        if (sectionIt == this->data.end() || std::wstring_view(sectionIt->first) != section) {
+            sectionIt = this->data.emplace_hint(sectionIt, std::wstring(section), section_type());
+        }
+        return sectionIt->second;
+    }
+
+    /**
+     * @brief Convert a value to its string representation.
+     *
+     * Strings and string views are copied as they are. Arithmetic types other than bool and character
+     * types are formatted with std::to_chars into a stack buffer, which is locale-independent and gives the
+     * shortest representation that round-trips for floating-point values. Anything else goes through a string stream.
+     *
+     * @param value The value to convert.
+     * @return The string representation of the value.
+     */
+    template <typename __T__>
+    static std::wstring format_value(const __T__& value) {
+        if constexpr (std::is_convertible_v<const __T__&, std::wstring_view>) {
+            return std::wstring(std::wstring_view(value));
+        }
+        else if constexpr (std::is_arithmetic_v<__T__> && !std::is_same_v<__T__, bool> &&
+            !std::is_same_v<__T__, char> && !std::is_same_v<__T__, signed char> && !std::is_same_v<__T__, unsigned char> &&
+            !std::is_same_v<__T__, wchar_t> && !std::is_same_v<__T__, char16_t> && !std::is_same_v<__T__, char32_t>) {
+            char buffer[64];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return std::wstring(buffer, result.ptr);
+        }
+        else {
+            std::wostringstream oss;
+            oss << value;
+            return oss.str();
+        }
+    }
+
+    /**
+     * @brief Check that no key of another parser conflicts with this one.
+     *
+     * @param other The parser that is about to be merged.
+     * @throws std::runtime_error If a key is defined by both parsers with different values.
+     */
+    void check_conflicts(const IniParserW& other) const {
+        for (const auto& section : other.data) {
+            auto sectionIt = this->data.find(section.first);
+            if (sectionIt == this->data.end()) {
+                continue;
+            }
+            for (const auto& pair : section.second) {
+                auto keyIt = sectionIt->second.find(pair.first);
+                if (keyIt != sectionIt->second.end() && keyIt->second != pair.second) {
+                    throw std::runtime_error("Conflicting values for the same key in merged parsers");
+                }
+            }
+        }
     }
 
 public:
@@ -481,7 +1588,9 @@ public:
      * @return True if the file was successfully written, false otherwise.
      */
     bool commit(const wchar_t* filename) {
-        std::wofstream file(filename);
+        XINI_STATS(IniStatsScope timer(this->counters.commitDuration));
+
+        std::wofstream file{ std::filesystem::path(filename) };
         if (!file.is_open()) {
             //std::wcerr << L"Error: failed to open file " << filename << L" for writing" << std::endl;
             return false;
@@ -489,9 +1598,19 @@ public:
 
         // Write sections and key-value pairs to file
         for (const auto& section : data) {
-            file << L"[" << section.first << L"]" << std::endl;
+            file << L"[" << section.first << L"]" << L'\n';
+            auto repeatedIt = this->repeated.find(section.first);
             for (const auto& pair : section.second) {
-                file << pair.first << L"=" << pair.second << std::endl;
+                if (repeatedIt != this->repeated.end()) {
+                    auto valuesIt = repeatedIt->second.find(pair.first);
+                    if (valuesIt != repeatedIt->second.end()) {
+                        for (const auto& value : valuesIt->second) {
+                            file << pair.first << L"=" << value << L'\n';
+                        }
+                        continue;
+                    }
+                }
+                file << pair.first << L"=" << pair.second << L'\n';
             }
         }
 
@@ -522,6 +1641,82 @@ public:
         this->parse_raw(content);
     }
 
+    /**
+     * @brief Parse an INI file, reporting malformed lines and the position of every key-value pair.
+     *
+     * The file is parsed exactly as operator>> does. Lines that operator>> silently ignores or keeps
+     * in a surprising form are reported as errors or warnings in the side table.
+     *
+     * @param filename The name of the INI file to parse.
+     * @param diagnostics The side table to fill. Previous diagnostics are kept.
+     * @return True if the file was successfully parsed, false otherwise.
+     */
+    bool load(const wchar_t* filename, IniDiagnosticsW& diagnostics) {
+        return this->parse_file(filename, &diagnostics);
+    }
+
+    /**
+     * @brief Parse INI content, reporting malformed lines and the position of every key-value pair.
+     *
+     * @param content The content of the INI file.
+     * @param diagnostics The side table to fill. Previous diagnostics are kept.
+     */
+    void load_string(const wchar_t* content, IniDiagnosticsW& diagnostics) {
+        this->parse_raw(content, &diagnostics);
+    }
+
+    /**
+     * @brief Parse a chunk of INI content, for example as it arrives from a pipe or a socket.
+     *
+     * Complete lines are parsed straight from the chunk. A line split across chunks is kept in a carry buffer,
+     * which only ever holds the unfinished line, and is parsed when its end arrives. The content
+     * does not have to be NUL-terminated. Call finish() after the last chunk.
+     *
+     * @param content The chunk.
+     * @param length The number of characters of the chunk.
+     */
+    void feed(const wchar_t* content, std::size_t length) {
+        const wchar_t* end = content + length;
+        while (content != end) {
+            const wchar_t* newline = std::char_traits<wchar_t>::find(content, static_cast<std::size_t>(end - content), L'\n');
+            if (newline == nullptr) {
+                this->carry.append(content, end);
+                return;
+            }
+            if (this->carry.empty()) {
+                this->parse_line(&this->carrySection, std::wstring_view(content, static_cast<std::size_t>(newline - content)));
+            }
+            else {
+                this->carry.append(content, newline);
+                this->parse_line(&this->carrySection, this->carry);
+                this->carry.clear();
+            }
+            content = newline + 1;
+        }
+    }
+
+    /**
+     * @brief Parse a chunk of INI content.
+     *
+     * @param content The chunk.
+     */
+    void feed(std::wstring_view content) {
+        this->feed(content.data(), content.size());
+    }
+
+    /**
+     * @brief Parse the last line fed, if it did not end with a newline, and reset the feed state.
+     *
+     * The next chunk fed starts a new content, outside of any section.
+     */
+    void finish() {
+        if (!this->carry.empty()) {
+            this->parse_line(&this->carrySection, this->carry);
+        }
+        this->carry.clear();
+        this->carrySection.clear();
+    }
+
     /**
      * @brief Get the value of a key in a section.
      *
@@ -532,7 +1727,7 @@ public:
      * @return The value of the key-value pair, or an empty string if the key does not exist.
      */
     template<typename __T__ = IniString>
-    __T__ get(const wchar_t* section, const wchar_t* var) {
+    __T__ get(std::wstring_view section, std::wstring_view var) {
         return static_cast<__T__>(this->getValue(section, var));
     }
 
@@ -547,13 +1742,58 @@ public:
      */
     template <typename __T__ = IniString>
     void set(const wchar_t* section, const wchar_t* var, const __T__& value) {
+        this->setValue(section, var, format_value(value));
+    }
 
-        std::wstringstream oss;
-        oss << value;
+    /**
+     * @brief Set the value of a key in a section, taking ownership of the string.
+     *
+     * This function moves the string into the data map without copying it.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    void set(const wchar_t* section, const wchar_t* var, std::wstring&& value) {
+        this->setValue(section, var, std::move(value));
+    }
 
-        this->setValue(section, var, oss.str());
+    /**
+     * @brief Set many keys of one section.
+     *
+     * This function looks the section up once and then inserts every key-value pair of the range,
+     * for example a std::vector or std::map of pairs. Values are converted like set() does. If the
+     * range is passed as an rvalue, string values are moved rather than copied.
+     *
+     * @param section The section of the key-value pairs.
+     * @param pairs The range of key-value pairs.
+     */
+    template <typename Range>
+    void set_many(const wchar_t* section, Range&& pairs) {
+        auto& target = this->section_at(section);
+        for (auto&& pair : pairs) {
+            std::wstring_view key(pair.first);
+            this->drop_values(section, key);
+            if constexpr (!std::is_lvalue_reference_v<Range> && std::is_same_v<std::decay_t<decltype(pair.second)>, std::wstring>) {
+                this->set_in_section(target, key, std::move(pair.second));
+            }
+            else {
+                this->set_in_section(target, key, format_value(pair.second));
+            }
+        }
     }
 
+    /**
+     * @brief Set many keys of one section.
+     *
+     * @param section The section of the key-value pairs.
+     * @param pairs The key-value pairs, for example {{"host", "localhost"}, {"port", "5432"}}.
+     */
+    void set_many(const wchar_t* section, std::initializer_list<std::pair<std::wstring_view, std::wstring_view>> pairs) {
+        this->set_many<const std::initializer_list<std::pair<std::wstring_view, std::wstring_view>>&>(section, pairs);
+    }
+
+
     /**
      * @brief Check if a key exists in a section.
      *
@@ -563,8 +1803,9 @@ public:
      * @param key The key of the key-value pair.
      * @return True if the key exists, false otherwise.
      */
-    bool exist(const wchar_t* section, const wchar_t* var) {
-        return !getValue(section, var).empty();
+    bool exist(std::wstring_view section, std::wstring_view var) const {
+        const std::wstring* value = this->lookup(section, var);
+        return value != nullptr && !value->empty();
     }
 
     /**
@@ -575,7 +1816,7 @@ public:
      * @param section The section to check.
      * @return True if the section exists, false otherwise.
      */
-    bool exist(const wchar_t* section) const {
+    bool exist(std::wstring_view section) const {
         return data.find(section) != data.end();
     }
 
@@ -587,8 +1828,16 @@ public:
      * @param section The section of the key-value pair.
      * @param key The key of the key-value pair to delete.
      */
-    void rem(const wchar_t* section, const wchar_t* key) {
-        data[section].erase(key);
+    void rem(std::wstring_view section, std::wstring_view key) {
+        this->drop_values(section, key);
+        auto sectionIt = this->data.find(section);
+        if (sectionIt == this->data.end()) {
+            return;
+        }
+        auto keyIt = sectionIt->second.find(key);
+        if (keyIt != sectionIt->second.end()) {
+            sectionIt->second.erase(keyIt);
+        }
     }
 
     /**
@@ -598,8 +1847,12 @@ public:
      *
      * @param section The section to delete.
      */
-    void rem(const wchar_t* section) {
-        data.erase(section);
+    void rem(std::wstring_view section) {
+        this->drop_values(section);
+        auto sectionIt = this->data.find(section);
+        if (sectionIt != this->data.end()) {
+            this->data.erase(sectionIt);
+        }
     }
 
     /**
@@ -610,9 +1863,70 @@ public:
      * @return The current data map.
      */
     std::map<std::wstring, std::map<std::wstring, std::wstring>> map() {
+        std::map<std::wstring, std::map<std::wstring, std::wstring>> result;
+        for (const auto& section : this->data) {
+            result.emplace_hint(result.end(), section.first, std::map<std::wstring, std::wstring>(section.second.begin(), section.second.end()));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get a read-only reference to the data map.
+     *
+     * Unlike map(), this function does not copy the data. The referenced sections and values
+     * may be changed or removed by any function that modifies the parser.
+     *
+     * @return A const reference to the current data map.
+     */
+    const data_type& view() const {
         return this->data;
     }
 
+    /**
+     * @brief Find the value of a key in a section without copying it.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @return A pointer to the stored value, or nullptr if the key does not exist. The pointer is
+     *         invalidated when the key or its section is removed.
+     */
+    const std::wstring* lookup(std::wstring_view section, std::wstring_view key) const {
+        auto sectionIt = this->data.find(section);
+        if (sectionIt == this->data.end()) {
+            XINI_STATS(this->counters.looked_up(false));
+            return nullptr;
+        }
+        auto keyIt = sectionIt->second.find(key);
+        XINI_STATS(this->counters.looked_up(keyIt != sectionIt->second.end()));
+        return keyIt != sectionIt->second.end() ? &keyIt->second : nullptr;
+    }
+
+    /**
+     * @brief Get every value of a key.
+     *
+     * When the parser reads repeated keys with IniDuplicateKeepAll, this returns all their values in the
+     * order of the lines. Otherwise, and for keys that appear once, it returns the single value of the key.
+     * Iterating the range does not allocate. Setting or removing the key drops its repeated values.
+     *
+     * @param section The section of the key.
+     * @param key The key.
+     * @return The values of the key, or an empty range if the key does not exist.
+     */
+    IniValueRange<std::wstring> values(std::wstring_view section, std::wstring_view key) const {
+        if (!this->repeated.empty()) {
+            auto sectionIt = this->repeated.find(section);
+            if (sectionIt != this->repeated.end()) {
+                auto keyIt = sectionIt->second.find(key);
+                if (keyIt != sectionIt->second.end()) {
+                    const std::wstring* first = keyIt->second.data();
+                    return { first, first + keyIt->second.size() };
+                }
+            }
+        }
+        const std::wstring* value = this->lookup(section, key);
+        return { value, value != nullptr ? value + 1 : nullptr };
+    }
+
     /**
      * @brief Conversion operator to IniMap (std::map<std::wstring, std::map<std::wstring, std::wstring>>).
      *
@@ -646,11 +1960,196 @@ public:
      * @param map The map containing the data to be loaded.
      */
     void loadmap(const std::map <std::wstring, std::map<std::wstring, std::wstring>>& map) {
+        data_type loaded;
+        for (const auto& section : map) {
+            loaded.emplace_hint(loaded.end(), section.first, section_type(section.second.begin(), section.second.end()));
+        }
+        this->data.swap(loaded);
+        this->repeated.clear();
+    }
+
+    /**
+     * @brief Load data from a map with transparent comparators, such as the one returned by view().
+     *
+     * @param map The map containing the data to be loaded.
+     */
+    void loadmap(const data_type& map) {
         this->data = map;
+        this->repeated.clear();
+    }
+
+    /**
+     * @brief Merge the data of another parser into this one.
+     *
+     * This function copies the sections and key-value pairs of another parser into this one.
+     * Sections missing from this parser are copied as a whole; keys defined by both parsers are
+     * resolved according to the merge policy. With IniMergeError, conflicts are checked before
+     * anything is copied, so a failed merge leaves this parser unchanged.
+     *
+     * @param other The parser to merge from.
+     * @param policy The policy applied to keys defined by both parsers.
+     * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
+     */
+    void merge(const IniParserW& other, IniMergePolicy policy = IniMergeLastWins) {
+        if (policy == IniMergeError) {
+            this->check_conflicts(other);
+        }
+        if (!this->repeated.empty() || !other.repeated.empty()) {
+            this->merge_values(other, policy);
+        }
+
+        // Both maps are sorted, so a single forward walk over this parser finds every insertion point,
+        // and each missing entry is inserted right before the cursor.
+        auto sectionLess = this->data.key_comp();
+        auto sectionIt = this->data.begin();
+        for (const auto& section : other.data) {
+            while (sectionIt != this->data.end() && sectionLess(sectionIt->first, section.first)) {
+                ++sectionIt;
+            }
+            if (sectionIt == this->data.end() || sectionLess(section.first, sectionIt->first)) {
+                this->data.emplace_hint(sectionIt, section);
+                XINI_STATS(this->count_merged(nullptr, section.second));
+                continue;
+            }
+
+            auto& target = sectionIt->second;
+            auto keyLess = target.key_comp();
+            auto keyIt = target.begin();
+            for (const auto& pair : section.second) {
+                while (keyIt != target.end() && keyLess(keyIt->first, pair.first)) {
+                    ++keyIt;
+                }
+                if (keyIt == target.end() || keyLess(pair.first, keyIt->first)) {
+                    target.emplace_hint(keyIt, pair);
+                    XINI_STATS(this->counters.inserted(IniEntryBytes(pair.first, pair.second)));
+                }
+                else if (policy == IniMergeLastWins) {
+                    keyIt->second = pair.second;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Merge the data of another parser into this one, taking ownership of it.
+     *
+     * This function moves the sections and key-value pairs of another parser into this one.
+     * Map nodes are spliced rather than copied: a section missing from this parser is transferred
+     * as a whole, and keys of a shared section are transferred one node at a time. Keys defined
+     * by both parsers are resolved according to the merge policy. The other parser is left empty.
+     *
+     * @param other The parser to merge from.
+     * @param policy The policy applied to keys defined by both parsers.
+     * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
+     */
+    void merge(IniParserW&& other, IniMergePolicy policy = IniMergeLastWins) {
+        if (policy == IniMergeError) {
+            this->check_conflicts(other);
+        }
+        if (!this->repeated.empty() || !other.repeated.empty()) {
+            this->merge_values(other, policy);
+            other.repeated.clear();
+        }
+
+        if (this->data.empty()) {
+            this->data.swap(other.data);
+            XINI_STATS(for (const auto& section : this->data) this->count_merged(nullptr, section.second));
+            return;
+        }
+
+        for (auto it = other.data.begin(); it != other.data.end();) {
+            auto next = std::next(it);
+            auto sectionIt = this->data.lower_bound(it->first);
+            XINI_STATS(this->count_merged(sectionIt == this->data.end() || sectionIt->first != it->first ? nullptr : &sectionIt->second, it->second));
+
+            if (sectionIt == this->data.end() || sectionIt->first != it->first) {
+                this->data.insert(sectionIt, other.data.extract(it));
+            }
+            else if (policy == IniMergeLastWins) {
+                // Splice the missing keys into the incoming section, so its values win, then adopt it.
+                it->second.merge(sectionIt->second);
+                sectionIt->second.swap(it->second);
+            }
+            else {
+                sectionIt->second.merge(it->second);
+            }
+
+            it = next;
+        }
+
+        other.data.clear();
+    }
+
+    /**
+     * @brief Get the instrumentation counters of the parser.
+     *
+     * The counters are only maintained when the library is compiled with XINI_ENABLE_STATS.
+     * Otherwise, every field of the result is 0 and the parser does not pay for them.
+     *
+     * @return A snapshot of the counters. Use IniStatsToPrometheus to export it.
+     */
+    IniStats stats() const {
+#if defined(XINI_ENABLE_STATS)
+        return this->counters.snapshot();
+#else
+        return IniStats();
+#endif
+    }
+
+    /**
+     * @brief Reset the instrumentation counters of the parser to 0.
+     */
+    void reset_stats() {
+        XINI_STATS(this->counters.reset());
+    }
+
+    /**
+     * @brief Get the dialect of the INI syntax read by the parser.
+     *
+     * @return The syntax options.
+     */
+    const IniDialect& dialect() const {
+        return this->syntax;
+    }
+
+    /**
+     * @brief Change the dialect of the INI syntax read by the parser.
+     *
+     * Only the content parsed from now on is affected.
+     *
+     * @param dialect The syntax options, for example IniDialect::relaxed().
+     */
+    void set_dialect(const IniDialect& dialect) {
+        this->syntax = dialect;
     }
 
 private:
-    std::map<std::wstring, std::map<std::wstring, std::wstring>> data;
+    template <typename Parser>
+    friend class IniBasicTransaction;
+
+    template <typename Parser>
+    friend class IniBasicJournal;
+
+    template <typename Parser>
+    friend class IniBasicParallelWriter;
+
+    data_type data;
+    IniDialect syntax;
+
+    /**
+     * @brief The unfinished line and the current section of the content passed to feed().
+     */
+    std::wstring carry;
+    std::wstring carrySection;
+
+    /**
+     * @brief Every value of the keys read more than once with IniDuplicateKeepAll, by section and key.
+     */
+    std::map<std::wstring, std::map<std::wstring, std::vector<std::wstring>, std::less<>>, std::less<>> repeated;
+
+#if defined(XINI_ENABLE_STATS)
+    mutable IniStatsCounters counters;
+#endif
 };
 
 #endif
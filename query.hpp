@@ -0,0 +1,200 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <string_view>
+#include                    <type_traits>
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+/**
+ * @brief A pair of iterators usable in a range-based for loop.
+ */
+template <typename Iterator>
+struct IniRange {
+    Iterator first;
+    Iterator last;
+
+    Iterator begin() const { return this->first; }
+    Iterator end() const { return this->last; }
+    bool empty() const { return this->first == this->last; }
+};
+
+/**
+ * @brief Check whether a comparator accepts keys of another type, like std::less<>.
+ */
+template <typename Compare, typename = void>
+struct IniIsTransparent : std::false_type {};
+
+template <typename Compare>
+struct IniIsTransparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+/**
+ * @brief Find the range of a sorted map whose keys start with a prefix.
+ *
+ * Keys sharing a prefix are adjacent in a std::map, so the range starts at lower_bound(prefix)
+ * and ends at the first key that no longer starts with it. No key is copied or compared outside the range.
+ *
+ * @param map The sorted map.
+ * @param prefix The prefix to look for.
+ * @return The range of entries whose key starts with the prefix.
+ */
+template <typename Map, typename CharT>
+IniRange<typename Map::const_iterator> IniPrefixRange(const Map& map, std::basic_string_view<CharT> prefix) {
+    auto first = map.end();
+    if constexpr (IniIsTransparent<typename Map::key_compare>::value) {
+        first = map.lower_bound(prefix);
+    }
+    else {
+        first = map.lower_bound(typename Map::key_type(prefix));
+    }
+    auto last = first;
+    while (last != map.end() && std::basic_string_view<CharT>(last->first).substr(0, prefix.size()) == prefix) {
+        ++last;
+    }
+    return { first, last };
+}
+
+/**
+ * @brief Match a string against a glob pattern.
+ *
+ * '*' matches any sequence of characters, including an empty one, and '?' matches any single character.
+ *
+ * @param pattern The glob pattern.
+ * @param text The string to match.
+ * @return True if the whole string matches the pattern, false otherwise.
+ */
+template <typename CharT>
+bool IniGlobMatch(std::basic_string_view<CharT> pattern, std::basic_string_view<CharT> text) {
+    std::size_t p = 0, t = 0;
+    std::size_t star = std::basic_string_view<CharT>::npos, resume = 0;
+
+    while (t < text.size()) {
+        // A '*' is a wildcard even where the text holds a literal '*', so it is tested first.
+        if (p < pattern.size() && pattern[p] == CharT('*')) {
+            star = p++;
+            resume = t;
+        }
+        else if (p < pattern.size() && (pattern[p] == CharT('?') || pattern[p] == text[t])) {
+            ++p;
+            ++t;
+        }
+        else if (star != std::basic_string_view<CharT>::npos) {
+            // Let the last '*' swallow one more character and retry.
+            p = star + 1;
+            t = ++resume;
+        }
+        else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == CharT('*')) {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+/**
+ * @brief Get the literal part of a glob pattern before its first wildcard.
+ */
+template <typename CharT>
+std::basic_string_view<CharT> IniGlobPrefix(std::basic_string_view<CharT> pattern) {
+    const CharT wildcards[] = { CharT('*'), CharT('?'), CharT(0) };
+    return pattern.substr(0, pattern.find_first_of(wildcards));
+}
+
+/**
+ * @brief Iterate over the sections whose name starts with a prefix.
+ *
+ * @param ini The parser to query.
+ * @param prefix The prefix of the section names, for example "service.".
+ * @return A range of (name, section) pairs, in name order. It is invalidated like view().
+ */
+template <typename Parser>
+auto IniSectionsWithPrefix(const Parser& ini, std::basic_string_view<typename Parser::char_type> prefix) {
+    return IniPrefixRange(ini.view(), prefix);
+}
+
+/**
+ * @brief Iterate over the keys of a section that start with a prefix.
+ *
+ * @param ini The parser to query.
+ * @param section The section to look in.
+ * @param prefix The prefix of the keys, for example "timeout.".
+ * @return A range of (key, value) pairs, in key order. It is empty if the section does not exist.
+ */
+template <typename Parser>
+auto IniKeysWithPrefix(const Parser& ini, std::basic_string_view<typename Parser::char_type> section, std::basic_string_view<typename Parser::char_type> prefix) {
+    typedef typename Parser::section_type section_type;
+
+    static const section_type none;
+
+    auto sectionIt = ini.view().find(section);
+    return IniPrefixRange(sectionIt != ini.view().end() ? sectionIt->second : none, prefix);
+}
+
+/**
+ * @brief Visit a section and every section below it in the dotted hierarchy.
+ *
+ * For the path "service.db", this visits "service.db" itself and every section whose name starts with
+ * "service.db.", such as "service.db.primary", but not siblings like "service.dbx". An empty path visits
+ * every section.
+ *
+ * @param ini The parser to query.
+ * @param path The dotted path of the subtree root.
+ * @param fn Called as fn(name, section) for each section of the subtree, in name order.
+ */
+template <typename Parser, typename Fn>
+void IniForEachSubtree(const Parser& ini, std::basic_string_view<typename Parser::char_type> path, Fn&& fn) {
+    typedef typename Parser::char_type char_type;
+    typedef typename Parser::string_type string_type;
+
+    if (path.empty()) {
+        for (const auto& section : ini.view()) {
+            fn(section.first, section.second);
+        }
+        return;
+    }
+
+    auto root = ini.view().find(path);
+    if (root != ini.view().end()) {
+        fn(root->first, root->second);
+    }
+
+    string_type childPrefix(path);
+    childPrefix += char_type('.');
+    for (const auto& section : IniPrefixRange(ini.view(), std::basic_string_view<char_type>(childPrefix))) {
+        fn(section.first, section.second);
+    }
+}
+
+/**
+ * @brief Visit every key-value pair whose section and key match glob patterns.
+ *
+ * Only the sections and keys sharing the literal prefix of their pattern (the part before the
+ * first '*' or '?') are examined, so a pattern like "service.*" does not scan the whole document.
+ *
+ * @param ini The parser to query.
+ * @param sectionPattern The glob pattern of the sections, for example "service.*".
+ * @param keyPattern The glob pattern of the keys, for example "timeout.*".
+ * @param fn Called as fn(section, key, value) for each match, in section then key order.
+ */
+template <typename Parser, typename Fn>
+void IniForEachMatch(const Parser& ini, std::basic_string_view<typename Parser::char_type> sectionPattern,
+    std::basic_string_view<typename Parser::char_type> keyPattern, Fn&& fn) {
+    typedef std::basic_string_view<typename Parser::char_type> view_type;
+
+    for (const auto& section : IniPrefixRange(ini.view(), IniGlobPrefix(sectionPattern))) {
+        if (!IniGlobMatch(sectionPattern, view_type(section.first))) {
+            continue;
+        }
+        for (const auto& pair : IniPrefixRange(section.second, IniGlobPrefix(keyPattern))) {
+            if (IniGlobMatch(keyPattern, view_type(pair.first))) {
+                fn(section.first, pair.first, pair.second);
+            }
+        }
+    }
+}
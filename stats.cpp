@@ -0,0 +1,99 @@
+#include "stats.hpp"
+
+#include <cstdio>
+
+static void AppendLabels(std::string& out, std::string_view labels, std::string_view extra)
+{
+    if (labels.empty() && extra.empty())
+    {
+        return;
+    }
+
+    out += '{';
+    out += labels;
+    if (!labels.empty() && !extra.empty())
+    {
+        out += ',';
+    }
+    out += extra;
+    out += '}';
+}
+
+static void AppendCounter(std::string& out, std::string_view prefix, std::string_view labels,
+    const char* name, const char* help, std::uint64_t value)
+{
+    std::string metric = std::string(prefix) + "_" + name;
+
+    out += "# HELP " + metric + " " + help + "\n";
+    out += "# TYPE " + metric + " counter\n";
+    out += metric;
+    AppendLabels(out, labels, "");
+    out += ' ';
+    out += std::to_string(value);
+    out += '\n';
+}
+
+static void AppendHistogram(std::string& out, std::string_view prefix, std::string_view labels,
+    const char* name, const char* help, const IniDurationHistogram& histogram)
+{
+    std::string metric = std::string(prefix) + "_" + name;
+
+    out += "# HELP " + metric + " " + help + "\n";
+    out += "# TYPE " + metric + " histogram\n";
+
+    // Prometheus buckets are cumulative, with their upper bound in seconds.
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < IniDurationHistogram::Buckets; ++i)
+    {
+        cumulative += histogram.counts[i];
+
+        char bound[32];
+        if (i + 1 < IniDurationHistogram::Buckets)
+        {
+            std::snprintf(bound, sizeof(bound), "le=\"%g\"", static_cast<double>(std::uint64_t(1) << i) * 1e-6);
+        }
+        else
+        {
+            std::snprintf(bound, sizeof(bound), "le=\"+Inf\"");
+        }
+
+        out += metric + "_bucket";
+        AppendLabels(out, labels, bound);
+        out += ' ';
+        out += std::to_string(cumulative);
+        out += '\n';
+    }
+
+    char sum[32];
+    std::snprintf(sum, sizeof(sum), "%.9g", static_cast<double>(histogram.sumNs) * 1e-9);
+
+    out += metric + "_sum";
+    AppendLabels(out, labels, "");
+    out += ' ';
+    out += sum;
+    out += '\n';
+
+    out += metric + "_count";
+    AppendLabels(out, labels, "");
+    out += ' ';
+    out += std::to_string(histogram.count);
+    out += '\n';
+}
+
+std::string IniStatsToPrometheus(const IniStats& stats, std::string_view prefix, std::string_view labels)
+{
+    std::string out;
+
+    AppendCounter(out, prefix, labels, "bytes_parsed_total", "Bytes of INI content parsed.", stats.bytesParsed);
+    AppendCounter(out, prefix, labels, "lines_parsed_total", "Lines of INI content parsed.", stats.linesParsed);
+    AppendCounter(out, prefix, labels, "keys_inserted_total", "Keys added by parsing or by set().", stats.keysInserted);
+    AppendCounter(out, prefix, labels, "lookups_total", "Lookups of a key.", stats.lookups);
+    AppendCounter(out, prefix, labels, "lookup_hits_total", "Lookups that found the key.", stats.lookupHits);
+    AppendCounter(out, prefix, labels, "lookup_misses_total", "Lookups that did not find the key.", stats.lookupMisses);
+    AppendCounter(out, prefix, labels, "allocated_bytes_total", "Estimated heap bytes of the inserted keys and values.", stats.bytesAllocated);
+
+    AppendHistogram(out, prefix, labels, "parse_duration_seconds", "Duration of parsing INI content.", stats.parseDuration);
+    AppendHistogram(out, prefix, labels, "commit_duration_seconds", "Duration of writing INI files.", stats.commitDuration);
+
+    return out;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief Distribution of durations in power-of-two buckets.
+ *
+ * Bucket i counts the durations shorter than 2^i microseconds that did not fit in a previous bucket.
+ * The last bucket counts everything longer.
+ */
+struct IniDurationHistogram {
+    static constexpr std::size_t Buckets = 24;
+
+    std::uint64_t counts[Buckets] = {};
+    std::uint64_t count = 0;
+    std::uint64_t sumNs = 0;
+};
+
+/**
+ * @brief Snapshot of the instrumentation counters of a parser.
+ *
+ * Every field stays 0 unless the library is compiled with XINI_ENABLE_STATS.
+ */
+struct IniStats {
+    std::uint64_t bytesParsed = 0;      ///< Bytes of INI content read by operator<< and operator>>.
+    std::uint64_t linesParsed = 0;      ///< Lines read by operator<< and operator>>.
+    std::uint64_t keysInserted = 0;     ///< Keys added by parsing, set(), set_many(), merge() or a transaction.
+    std::uint64_t lookups = 0;          ///< Calls of get(), exist() and lookup().
+    std::uint64_t lookupHits = 0;       ///< Lookups that found the key.
+    std::uint64_t lookupMisses = 0;     ///< Lookups that did not find the key.
+    std::uint64_t bytesAllocated = 0;   ///< Estimated heap bytes of the inserted map nodes, keys and values.
+
+    IniDurationHistogram parseDuration;     ///< Duration of operator<< and operator>>.
+    IniDurationHistogram commitDuration;    ///< Duration of commit().
+};
+
+/**
+ * @brief Estimate the heap bytes used by a string.
+ *
+ * @param str The string.
+ * @return The size of its heap buffer, or 0 if its characters are stored in the string object itself.
+ */
+template <typename CharT>
+std::size_t IniHeapBytes(const std::basic_string<CharT>& str) {
+    const char* data = reinterpret_cast<const char*>(str.data());
+    const char* object = reinterpret_cast<const char*>(&str);
+    if (data >= object && data < object + sizeof(str)) {
+        return 0;
+    }
+    return (str.capacity() + 1) * sizeof(CharT);
+}
+
+/**
+ * @brief Estimate the heap bytes used by a key-value pair stored in a std::map.
+ *
+ * @param key The key of the pair.
+ * @param value The value of the pair.
+ * @return The size of the map node, of its header, and of the heap buffers of the key and value.
+ */
+template <typename CharT>
+std::size_t IniEntryBytes(const std::basic_string<CharT>& key, const std::basic_string<CharT>& value) {
+    // A red-black tree node holds the pair, three links and its color.
+    return sizeof(std::pair<const std::basic_string<CharT>, std::basic_string<CharT>>) + 4 * sizeof(void*) +
+        IniHeapBytes(key) + IniHeapBytes(value);
+}
+
+/**
+ * @brief Thread-safe histogram of durations.
+ */
+class IniDurationCounter {
+public:
+    IniDurationCounter() {
+        this->reset();
+    }
+
+    IniDurationCounter(const IniDurationCounter& other) {
+        this->load(other.snapshot());
+    }
+
+    IniDurationCounter& operator=(const IniDurationCounter& other) {
+        this->load(other.snapshot());
+        return *this;
+    }
+
+    /**
+     * @brief Record a duration.
+     *
+     * @param ns The duration, in nanoseconds.
+     */
+    void record(std::uint64_t ns) {
+        std::size_t bucket = 0;
+        for (std::uint64_t us = ns / 1000; us && bucket < IniDurationHistogram::Buckets - 1; us >>= 1) {
+            ++bucket;
+        }
+        this->counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        this->count.fetch_add(1, std::memory_order_relaxed);
+        this->sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    IniDurationHistogram snapshot() const {
+        IniDurationHistogram histogram;
+        for (std::size_t i = 0; i < IniDurationHistogram::Buckets; ++i) {
+            histogram.counts[i] = this->counts[i].load(std::memory_order_relaxed);
+        }
+        histogram.count = this->count.load(std::memory_order_relaxed);
+        histogram.sumNs = this->sumNs.load(std::memory_order_relaxed);
+        return histogram;
+    }
+
+    void reset() {
+        this->load(IniDurationHistogram());
+    }
+
+    void load(const IniDurationHistogram& histogram) {
+        for (std::size_t i = 0; i < IniDurationHistogram::Buckets; ++i) {
+            this->counts[i].store(histogram.counts[i], std::memory_order_relaxed);
+        }
+        this->count.store(histogram.count, std::memory_order_relaxed);
+        this->sumNs.store(histogram.sumNs, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> counts[IniDurationHistogram::Buckets];
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::uint64_t> sumNs;
+};
+
+/**
+ * @brief Instrumentation counters embedded in a parser when XINI_ENABLE_STATS is defined.
+ *
+ * The counters are relaxed atomics, so const lookups from several threads can update them.
+ * Copying a parser copies the current values.
+ */
+class IniStatsCounters {
+public:
+    IniStatsCounters() {
+        this->reset();
+    }
+
+    IniStatsCounters(const IniStatsCounters& other) {
+        this->load(other.snapshot());
+    }
+
+    IniStatsCounters& operator=(const IniStatsCounters& other) {
+        this->load(other.snapshot());
+        return *this;
+    }
+
+    void parsed_line(std::size_t bytes) {
+        this->bytesParsed.fetch_add(bytes, std::memory_order_relaxed);
+        this->linesParsed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void inserted(std::size_t bytes) {
+        this->keysInserted.fetch_add(1, std::memory_order_relaxed);
+        this->bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void looked_up(bool hit) {
+        this->lookups.fetch_add(1, std::memory_order_relaxed);
+        (hit ? this->lookupHits : this->lookupMisses).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    IniStats snapshot() const {
+        IniStats stats;
+        stats.bytesParsed = this->bytesParsed.load(std::memory_order_relaxed);
+        stats.linesParsed = this->linesParsed.load(std::memory_order_relaxed);
+        stats.keysInserted = this->keysInserted.load(std::memory_order_relaxed);
+        stats.lookups = this->lookups.load(std::memory_order_relaxed);
+        stats.lookupHits = this->lookupHits.load(std::memory_order_relaxed);
+        stats.lookupMisses = this->lookupMisses.load(std::memory_order_relaxed);
+        stats.bytesAllocated = this->bytesAllocated.load(std::memory_order_relaxed);
+        stats.parseDuration = this->parseDuration.snapshot();
+        stats.commitDuration = this->commitDuration.snapshot();
+        return stats;
+    }
+
+    void reset() {
+        this->load(IniStats());
+    }
+
+    IniDurationCounter parseDuration;
+    IniDurationCounter commitDuration;
+
+private:
+    void load(const IniStats& stats) {
+        this->bytesParsed.store(stats.bytesParsed, std::memory_order_relaxed);
+        this->linesParsed.store(stats.linesParsed, std::memory_order_relaxed);
+        this->keysInserted.store(stats.keysInserted, std::memory_order_relaxed);
+        this->lookups.store(stats.lookups, std::memory_order_relaxed);
+        this->lookupHits.store(stats.lookupHits, std::memory_order_relaxed);
+        this->lookupMisses.store(stats.lookupMisses, std::memory_order_relaxed);
+        this->bytesAllocated.store(stats.bytesAllocated, std::memory_order_relaxed);
+        this->parseDuration.load(stats.parseDuration);
+        this->commitDuration.load(stats.commitDuration);
+    }
+
+    std::atomic<std::uint64_t> bytesParsed;
+    std::atomic<std::uint64_t> linesParsed;
+    std::atomic<std::uint64_t> keysInserted;
+    std::atomic<std::uint64_t> lookups;
+    std::atomic<std::uint64_t> lookupHits;
+    std::atomic<std::uint64_t> lookupMisses;
+    std::atomic<std::uint64_t> bytesAllocated;
+};
+
+/**
+ * @brief Record the time spent in a scope into a duration counter.
+ */
+class IniStatsScope {
+public:
+    explicit IniStatsScope(IniDurationCounter& counter)
+        : counter(counter), start(std::chrono::steady_clock::now()) {}
+
+    ~IniStatsScope() {
+        auto elapsed = std::chrono::steady_clock::now() - this->start;
+        this->counter.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    IniStatsScope(const IniStatsScope&) = delete;
+    IniStatsScope& operator=(const IniStatsScope&) = delete;
+
+private:
+    IniDurationCounter& counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Format parser statistics in the Prometheus text exposition format.
+ *
+ * Counters are exported as "<prefix>_bytes_parsed_total" and so on, and durations as histograms
+ * in seconds, "<prefix>_parse_duration_seconds" and "<prefix>_commit_duration_seconds".
+ *
+ * @param stats The statistics, for example ini.stats().
+ * @param prefix The prefix of the metric names.
+ * @param labels Labels added to every sample, for example "service=\"api\"", or an empty string.
+ * @return The metrics, one sample per line.
+ */
+std::string IniStatsToPrometheus(const IniStats& stats, std::string_view prefix = "xini", std::string_view labels = "");
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief Policy applied by the parsers when a key appears several times in the same section.
+ */
+enum IniDuplicatePolicy {
+    IniDuplicateLastWins = 0,   ///< The last value is kept.
+    IniDuplicateFirstWins,      ///< The first value is kept.
+    IniDuplicateKeepAll         ///< Every value is kept, see IniParser::values(). get() returns the last one.
+};
+
+/**
+ * @brief Syntax options of the INI tokenizer.
+ *
+ * The default dialect is the historical one: spaces around '=' and a trailing '\r' are kept in keys
+ * and values, and only lines starting with ';' are comments. Every option is applied during the single
+ * scan of a line, so the tokens are spans of the line and nothing has to be trimmed or copied afterwards.
+ */
+struct IniDialect {
+    bool trim = false;                  ///< Strip blanks around section names, keys and values.
+    bool stripCarriageReturn = false;   ///< Drop the '\r' left at the end of the lines of CRLF files.
+    bool hashComments = false;          ///< Lines starting with '#' are comments, like lines starting with ';'.
+    bool inlineComments = false;        ///< A ';' or '#' at the start of a value or after a blank starts a comment.
+    bool quotedValues = false;          ///< A value enclosed in double quotes is taken verbatim, without the quotes, if only blanks or a comment follow them.
+    IniDuplicatePolicy duplicates = IniDuplicateLastWins;   ///< What the parsers do with repeated keys.
+
+    /**
+     * @brief The historical dialect, with every option off.
+     */
+    static IniDialect legacy() {
+        return IniDialect();
+    }
+
+    /**
+     * @brief A dialect with every syntax option on, for hand-written files. Repeated keys keep the last value.
+     */
+    static IniDialect relaxed() {
+        IniDialect dialect;
+        dialect.trim = true;
+        dialect.stripCarriageReturn = true;
+        dialect.hashComments = true;
+        dialect.inlineComments = true;
+        dialect.quotedValues = true;
+        return dialect;
+    }
+};
+
+/**
+ * @brief Kind of a tokenized line.
+ */
+enum IniTokenKind {
+    IniTokenEmpty = 0,  ///< An empty line or a comment.
+    IniTokenSection,    ///< A section header.
+    IniTokenPair,       ///< A key-value pair.
+    IniTokenInvalid     ///< Anything else. The line is ignored by the parsers.
+};
+
+/**
+ * @brief A tokenized line. The views point into the line.
+ */
+template <typename CharT>
+struct IniBasicToken {
+    IniTokenKind kind = IniTokenEmpty;
+    std::basic_string_view<CharT> section;  ///< The name of the section, for IniTokenSection.
+    std::basic_string_view<CharT> key;      ///< The key, for IniTokenPair.
+    std::basic_string_view<CharT> value;    ///< The value, for IniTokenPair.
+    std::size_t keyColumn = 0;              ///< The column of the key or of the section name, starting at 1.
+    std::size_t valueColumn = 0;            ///< The column of the value, starting at 1.
+};
+
+/**
+ * @brief Tokenized line of an IniParserA.
+ */
+typedef IniBasicToken<char>         IniTokenA;
+
+/**
+ * @brief Tokenized line of an IniParserW.
+ */
+typedef IniBasicToken<wchar_t>      IniTokenW;
+
+/**
+ * @brief Check whether a character is a blank for the tokenizer.
+ */
+template <typename CharT>
+constexpr bool IniIsBlank(CharT c) {
+    return c == CharT(' ') || c == CharT('\t');
+}
+
+/**
+ * @brief Remove the blanks around a span, moving its column along.
+ */
+template <typename CharT>
+std::basic_string_view<CharT> IniTrimSpan(std::basic_string_view<CharT> text, std::size_t& column) {
+    std::size_t first = 0;
+    while (first < text.size() && IniIsBlank(text[first])) {
+        ++first;
+    }
+    std::size_t last = text.size();
+    while (last > first && IniIsBlank(text[last - 1])) {
+        --last;
+    }
+    column += first;
+    return text.substr(first, last - first);
+}
+
+/**
+ * @brief Find where an inline comment starts.
+ *
+ * @return The position of the ';' or '#' starting the comment, or the size of the text if there is none.
+ */
+template <typename CharT>
+std::size_t IniCommentStart(std::basic_string_view<CharT> text) {
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if ((text[i] == CharT(';') || text[i] == CharT('#')) && (i == 0 || IniIsBlank(text[i - 1]))) {
+            return i;
+        }
+    }
+    return text.size();
+}
+
+/**
+ * @brief Split a line of an INI file into a section header or a key-value pair.
+ *
+ * With the legacy dialect, a line starting with ';' is a comment, a line starting with '[' and ending
+ * with ']' is a section header, and any other line is split at its first '='.
+ *
+ * @param line The line, without its '\n'.
+ * @param dialect The syntax options.
+ * @return The token. Its views point into the line.
+ */
+template <typename CharT>
+IniBasicToken<CharT> IniTokenize(std::basic_string_view<CharT> line, const IniDialect& dialect) {
+    typedef std::basic_string_view<CharT> view_type;
+
+    IniBasicToken<CharT> token;
+    if (dialect.stripCarriageReturn && !line.empty() && line.back() == CharT('\r')) {
+        line.remove_suffix(1);
+    }
+
+    std::size_t start = 0;
+    if (dialect.trim) {
+        while (start < line.size() && IniIsBlank(line[start])) {
+            ++start;
+        }
+    }
+    if (start == line.size() || line[start] == CharT(';') || (dialect.hashComments && line[start] == CharT('#'))) {
+        return token;
+    }
+
+    if (line[start] == CharT('[')) {
+        view_type header = line.substr(start);
+        if (dialect.inlineComments) {
+            header = header.substr(0, IniCommentStart(header));
+        }
+        if (dialect.trim || dialect.inlineComments) {
+            while (!header.empty() && IniIsBlank(header.back())) {
+                header.remove_suffix(1);
+            }
+        }
+        if (header.size() >= 2 && header.back() == CharT(']')) {
+            token.kind = IniTokenSection;
+            token.keyColumn = start + 2;
+            token.section = header.substr(1, header.size() - 2);
+            if (dialect.trim) {
+                token.section = IniTrimSpan(token.section, token.keyColumn);
+            }
+            return token;
+        }
+    }
+
+    std::size_t equalPos = line.find(CharT('='), start);
+    if (equalPos == view_type::npos) {
+        token.kind = IniTokenInvalid;
+        return token;
+    }
+
+    token.kind = IniTokenPair;
+    token.keyColumn = start + 1;
+    token.key = line.substr(start, equalPos - start);
+    token.valueColumn = equalPos + 2;
+    token.value = line.substr(equalPos + 1);
+
+    if (dialect.trim) {
+        token.key = IniTrimSpan(token.key, token.keyColumn);
+        token.value = IniTrimSpan(token.value, token.valueColumn);
+    }
+
+    if (dialect.quotedValues && token.value.size() >= 1 && token.value.front() == CharT('"')) {
+        std::size_t close = token.value.find(CharT('"'), 1);
+        if (close != view_type::npos) {
+            // Text after the closing quote, as in k="a"b, makes the whole value an unquoted one.
+            std::size_t rest = close + 1;
+            while (rest < token.value.size() && IniIsBlank(token.value[rest])) {
+                ++rest;
+            }
+            bool comment = dialect.inlineComments && rest > close + 1 && rest < token.value.size() &&
+                (token.value[rest] == CharT(';') || token.value[rest] == CharT('#'));
+            if (rest == token.value.size() || comment) {
+                token.value = token.value.substr(1, close - 1);
+                token.valueColumn += 1;
+                return token;
+            }
+        }
+    }
+
+    if (dialect.inlineComments) {
+        token.value = token.value.substr(0, IniCommentStart(token.value));
+        if (dialect.trim) {
+            while (!token.value.empty() && IniIsBlank(token.value.back())) {
+                token.value.remove_suffix(1);
+            }
+        }
+    }
+    return token;
+}
@@ -0,0 +1,417 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <vector>
+#include                    <map>
+#include                    <set>
+#include                    <mutex>
+#include                    <utility>
+
+#include                    "parser.hpp"
+
+#pragma endregion
+
+/**
+ * @brief A batch of edits applied to a parser all at once.
+ *
+ * set() and rem() calls are recorded in a log instead of modifying the parser. apply() then works in two
+ * phases: it first builds the new content of every section touched by the batch, without modifying the
+ * parser, and then publishes these sections by swapping map nodes, which neither allocates nor throws.
+ * If building the sections fails, the parser is left unchanged; once published, every edit is visible.
+ *
+ * The sections replaced by apply() are kept, so rollback() can restore them until a new edit is recorded.
+ * Setting or removing a key drops its repeated values (see IniParser::values()); the values of the keys the
+ * batch does not touch are kept, and rollback() restores the dropped ones as well.
+ *
+ * A transaction that is destroyed without being applied has no effect.
+ */
+template <typename Parser>
+class IniBasicTransaction {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+
+    /**
+     * @brief Constructor. Starts an empty batch of edits.
+     *
+     * @param target The parser the edits are applied to. It must outlive the transaction.
+     */
+    explicit IniBasicTransaction(Parser& target) : target(target), applied(false) {}
+
+    IniBasicTransaction(const IniBasicTransaction&) = delete;
+    IniBasicTransaction& operator=(const IniBasicTransaction&) = delete;
+
+    /**
+     * @brief Record setting the value of a key in a section.
+     *
+     * The value is converted to a string right away, like IniParser::set() does.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    template <typename __T__ = string_type>
+    void set(const char_type* section, const char_type* key, const __T__& value) {
+        this->record(OpSet, section, key, Parser::format_value(value));
+    }
+
+    /**
+     * @brief Record setting the value of a key in a section, taking ownership of the string.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value to set.
+     */
+    void set(const char_type* section, const char_type* key, string_type&& value) {
+        this->record(OpSet, section, key, std::move(value));
+    }
+
+    /**
+     * @brief Record deleting a key from a section.
+     *
+     * Unlike IniParser::rem(), this does not create the section if it does not exist.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair to delete.
+     */
+    void rem(const char_type* section, const char_type* key) {
+        this->record(OpRemoveKey, section, key, string_type());
+    }
+
+    /**
+     * @brief Record deleting a section.
+     *
+     * @param section The section to delete.
+     */
+    void rem(const char_type* section) {
+        this->record(OpRemoveSection, section, string_type(), string_type());
+    }
+
+    /**
+     * @brief Get the number of recorded edits that have not been applied yet.
+     *
+     * @return The number of pending edits.
+     */
+    std::size_t size() const {
+        return this->log.size();
+    }
+
+    /**
+     * @brief Check if there are no pending edits.
+     *
+     * @return True if no edit has been recorded since the last apply() or rollback(), false otherwise.
+     */
+    bool empty() const {
+        return this->log.empty();
+    }
+
+    /**
+     * @brief Apply the pending edits to the parser.
+     *
+     * @throws std::bad_alloc If the new sections cannot be built. The parser is left unchanged and the pending edits are discarded.
+     */
+    void apply() {
+        this->stage();
+        this->publish();
+    }
+
+    /**
+     * @brief Apply the pending edits to the parser, holding a lock only while they are published.
+     *
+     * The new sections are built before the lock is taken, so readers that share the lock with the
+     * transaction are only blocked while map nodes are swapped. Building the sections reads the parser,
+     * so no other thread may modify it in the meantime.
+     *
+     * @param lock The lock protecting the parser, for example a std::mutex.
+     */
+    template <typename Lockable>
+    void apply(Lockable& lock) {
+        this->stage();
+        std::lock_guard<Lockable> guard(lock);
+        this->publish();
+    }
+
+    /**
+     * @brief Apply the pending edits and write the parser to an INI file.
+     *
+     * The file is written once for the whole batch. If it cannot be written, the edits are rolled
+     * back, so the parser keeps matching the content of the file.
+     *
+     * @param filename The name of the INI file to write to.
+     * @return True if the edits were applied and the file was written, false otherwise.
+     */
+    bool commit(const char_type* filename) {
+        this->apply();
+        if (!this->target.commit(filename)) {
+            this->rollback();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Discard the pending edits, or undo the last apply().
+     *
+     * If edits are pending, they are discarded and the parser is not touched. Otherwise, the sections
+     * changed by the last apply() are restored to their previous content. The parser should not have
+     * been modified by other means in between.
+     */
+    void rollback() {
+        if (!this->log.empty() || !this->applied) {
+            this->log.clear();
+            return;
+        }
+
+        auto& data = this->target.data;
+        for (const auto& section : this->created) {
+            data.erase(section);
+        }
+
+        auto& values = this->target.repeated;
+        while (!this->droppedSections.empty()) {
+            values.insert(std::move(this->droppedSections.back()));
+            this->droppedSections.pop_back();
+        }
+        for (auto& dropped : this->droppedKeys) {
+            auto sectionIt = values.find(dropped.section);
+            if (dropped.node && sectionIt != values.end()) {
+                sectionIt->second.insert(std::move(dropped.node));
+            }
+        }
+
+        while (!this->previous.empty()) {
+            auto node = this->previous.extract(this->previous.begin());
+            auto sectionIt = data.find(node.key());
+            if (sectionIt != data.end()) {
+                sectionIt->second.swap(node.mapped());
+            }
+            else {
+                data.insert(std::move(node));
+            }
+        }
+
+        this->forget();
+    }
+
+private:
+    typedef std::remove_const_t<std::remove_reference_t<decltype(std::declval<const Parser&>().view())>> data_type;
+    typedef decltype(std::declval<Parser&>().repeated) values_type;
+
+    enum OpKind {
+        OpSet,
+        OpRemoveKey,
+        OpRemoveSection
+    };
+
+    struct Op {
+        OpKind kind;
+        string_type section;
+        string_type key;
+        string_type value;
+    };
+
+    /**
+     * @brief A key whose repeated values are dropped by publish(), and kept here for rollback().
+     */
+    struct DroppedKey {
+        string_type section;
+        string_type key;
+        typename values_type::mapped_type::node_type node;
+    };
+
+    void record(OpKind kind, string_type section, string_type key, string_type value) {
+        if (this->applied) {
+            // A new batch makes the previous one permanent.
+            this->forget();
+        }
+        this->log.push_back({ kind, std::move(section), std::move(key), std::move(value) });
+    }
+
+    void forget() {
+        this->applied = false;
+        this->staged.clear();
+        this->removed.clear();
+        this->created.clear();
+        this->previous.clear();
+        this->droppedKeys.clear();
+        this->droppedSections.clear();
+        this->clearedSections.clear();
+    }
+
+    /**
+     * @brief Build the new content of every touched section, without modifying the parser.
+     */
+    void stage() {
+        this->forget();
+
+        try {
+            this->build();
+        }
+        catch (...) {
+            // The log has been partly consumed, so the batch cannot be retried.
+            this->log.clear();
+            this->forget();
+            throw;
+        }
+    }
+
+    void build() {
+        const auto& data = this->target.data;
+
+        // Keys set or removed by the batch, and sections removed at some point of it, lose their repeated values.
+        std::map<string_type, std::set<string_type>, std::less<>> touched;
+        std::set<string_type, std::less<>> cleared;
+
+        for (auto& op : this->log) {
+            auto stagedIt = this->staged.find(op.section);
+
+            if (stagedIt == this->staged.end()) {
+                auto removedIt = this->removed.find(op.section);
+                auto sectionIt = data.find(op.section);
+
+                if (removedIt == this->removed.end() && sectionIt != data.end()) {
+                    // First edit of an existing section: start from a copy of it.
+                    stagedIt = this->staged.emplace(op.section, sectionIt->second).first;
+                }
+                else if (op.kind == OpSet) {
+                    stagedIt = this->staged.emplace(op.section, typename data_type::mapped_type()).first;
+                    if (removedIt != this->removed.end()) {
+                        this->removed.erase(removedIt);
+                    }
+                }
+                else {
+                    // Nothing to delete from a section that does not exist.
+                    continue;
+                }
+            }
+
+            switch (op.kind) {
+            case OpSet:
+                touched[op.section].insert(op.key);
+                stagedIt->second.insert_or_assign(std::move(op.key), std::move(op.value));
+                break;
+            case OpRemoveKey:
+                touched[op.section].insert(op.key);
+                stagedIt->second.erase(op.key);
+                break;
+            case OpRemoveSection:
+                cleared.insert(op.section);
+                this->staged.erase(stagedIt);
+                this->removed.insert(std::move(op.section));
+                break;
+            }
+        }
+
+        const auto& values = this->target.repeated;
+        for (const auto& section : cleared) {
+            if (values.find(section) != values.end()) {
+                this->clearedSections.push_back(section);
+            }
+        }
+        for (const auto& section : touched) {
+            auto valuesIt = values.find(section.first);
+            if (valuesIt == values.end() || cleared.find(section.first) != cleared.end()) {
+                continue;
+            }
+            for (const auto& key : section.second) {
+                if (valuesIt->second.find(key) != valuesIt->second.end()) {
+                    this->droppedKeys.push_back({ section.first, key, {} });
+                }
+            }
+        }
+        // publish() moves the emptied sections here, and must not allocate.
+        this->droppedSections.reserve(this->clearedSections.size() + this->droppedKeys.size());
+
+        for (const auto& section : this->staged) {
+            if (data.find(section.first) == data.end()) {
+                this->created.push_back(section.first);
+            }
+        }
+    }
+
+    /**
+     * @brief Swap the staged sections into the parser. Does not allocate.
+     */
+    void publish() {
+        auto& data = this->target.data;
+        auto& values = this->target.repeated;
+
+        for (auto& dropped : this->droppedKeys) {
+            auto sectionIt = values.find(dropped.section);
+            dropped.node = sectionIt->second.extract(dropped.key);
+            if (sectionIt->second.empty()) {
+                this->droppedSections.push_back(values.extract(sectionIt));
+            }
+        }
+        for (const auto& section : this->clearedSections) {
+            this->droppedSections.push_back(values.extract(section));
+        }
+
+        for (auto it = this->staged.begin(); it != this->staged.end();) {
+            auto next = std::next(it);
+            auto sectionIt = data.find(it->first);
+            XINI_STATS(this->target.count_merged(sectionIt != data.end() ? &sectionIt->second : nullptr, it->second));
+            if (sectionIt != data.end()) {
+                // The staged node now holds the previous content, which rollback() restores.
+                sectionIt->second.swap(it->second);
+                this->previous.insert(this->staged.extract(it));
+            }
+            else {
+                data.insert(this->staged.extract(it));
+            }
+            it = next;
+        }
+
+        for (const auto& section : this->removed) {
+            auto node = data.extract(section);
+            if (node) {
+                this->previous.insert(std::move(node));
+            }
+        }
+
+        this->log.clear();
+        this->staged.clear();
+        this->removed.clear();
+        this->applied = true;
+    }
+
+    Parser& target;
+    std::vector<Op> log;
+    bool applied;
+
+    data_type staged;
+    std::set<string_type> removed;
+    std::vector<string_type> created;
+    data_type previous;
+
+    std::vector<DroppedKey> droppedKeys;
+    std::vector<string_type> clearedSections;
+    std::vector<typename values_type::node_type> droppedSections;
+};
+
+/**
+ * @brief Transaction over an IniParserA.
+ */
+typedef IniBasicTransaction<IniParserA>     IniTransactionA;
+
+/**
+ * @brief Transaction over an IniParserW.
+ */
+typedef IniBasicTransaction<IniParserW>     IniTransactionW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the transaction type based on whether the _UNICODE macro is defined.
+ */
+# define IniTransaction     IniTransactionW
+
+#else
+
+/**
+ * @brief Macro that defines the transaction type based on whether the _UNICODE macro is defined.
+ */
+# define IniTransaction     IniTransactionA
+
+#endif
@@ -41,43 +41,3 @@ IniParserA ToIniParserA(IniParserW& wideParser) {
 	asciiParser.loadmap(WMapToAMap(wideParser.map()));
 	return asciiParser;
 }
-
-IniParserA MergeIniParsersA(IniParserA parser1, IniParserA parser2, ...) {
-	IniParserA mergedParser = parser1;
-
-	va_list args;
-	va_start(args, parser2);
-	IniParserA* currentParser = &parser2;
-
-	while (currentParser != nullptr) {
-		for (const auto& section : currentParser->map()) {
-			for (const auto& pair : section.second) {
-				mergedParser.set(section.first.c_str(), pair.first.c_str(), pair.second);
-			}
-		}
-		currentParser = va_arg(args, IniParserA*);
-	}
-	va_end(args);
-
-	return mergedParser;
-}
-
-IniParserW MergeIniParsersW(IniParserW parser1, IniParserW parser2, ...) {
-	IniParserW mergedParser = parser1;
-
-	va_list args;
-	va_start(args, parser2);
-	IniParserW* currentParser = &parser2;
-
-	while (currentParser != nullptr) {
-		for (const auto& section : currentParser->map()) {
-			for (const auto& pair : section.second) {
-				mergedParser.set(section.first.c_str(), pair.first.c_str(), pair.second);
-			}
-		}
-		currentParser = va_arg(args, IniParserW*);
-	}
-	va_end(args);
-
-	return mergedParser;
-}
\ No newline at end of file
@@ -2,7 +2,8 @@
 
 #pragma region              includes
 
-#include                    <cstdarg>
+#include                    <type_traits>
+#include                    <utility>
 #include                    <locale>
 #include                    <codecvt>
 
@@ -19,6 +20,11 @@
  */
 # define IniMerge          MergeIniParsersW
 
+/**
+ * @brief Macro that defines the function to merge a range of IniParserW objects.
+ */
+# define IniMergeRange     MergeIniParserRangeW
+
 /**
  * @brief Macro that defines the function to convert from IniParserA to IniParserW.
  */
@@ -31,6 +37,11 @@
  */
 # define IniMerge          MergeIniParsersA
 
+/**
+ * @brief Macro that defines the function to merge a range of IniParserA objects.
+ */
+# define IniMergeRange     MergeIniParserRangeA
+
 /**
  * @brief Macro that defines the function to convert from IniParserW to IniParserA.
  */
@@ -83,23 +94,119 @@ IniParserA ToIniParserA(IniParserW& wideParser);
 /**
  * @brief Merge multiple IniParserA objects into one.
  *
- * This function merges multiple IniParserA objects into one.
+ * This function merges any number of IniParserA objects, in order, into a new parser. Parsers passed
+ * as lvalues are copied from; parsers passed as rvalues (std::move) are spliced without copying their
+ * sections and values. The first parser is moved or copied into the result as a whole.
+ *
+ * @param policy The policy applied to keys defined by more than one parser.
+ * @param first The first IniParserA object to merge.
+ * @param rest Additional IniParserA objects to merge.
+ * @return The merged IniParserA object.
+ * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
+ */
+template <typename First, typename... Rest>
+IniParserA MergeIniParsersA(IniMergePolicy policy, First&& first, Rest&&... rest) {
+    static_assert(std::is_same_v<std::decay_t<First>, IniParserA> && (std::is_same_v<std::decay_t<Rest>, IniParserA> && ...),
+        "MergeIniParsersA only accepts IniParserA objects");
+
+    IniParserA mergedParser(std::forward<First>(first));
+    (mergedParser.merge(std::forward<Rest>(rest), policy), ...);
+    return mergedParser;
+}
+
+/**
+ * @brief Merge multiple IniParserA objects into one, the last value of a key winning.
+ *
+ * @param first The first IniParserA object to merge.
+ * @param rest Additional IniParserA objects to merge.
+ * @return The merged IniParserA object.
+ */
+template <typename First, typename... Rest, typename = std::enable_if_t<std::is_same_v<std::decay_t<First>, IniParserA>>>
+IniParserA MergeIniParsersA(First&& first, Rest&&... rest) {
+    return MergeIniParsersA(IniMergeLastWins, std::forward<First>(first), std::forward<Rest>(rest)...);
+}
+
+/**
+ * @brief Merge a range of IniParserA objects into one.
+ *
+ * This function merges the parsers of a range (for example a std::vector<IniParserA>), in order,
+ * into a new parser. If the range itself is passed as an rvalue, its parsers are spliced instead of copied.
  *
- * @param parser1 The first IniParserA object to merge.
- * @param parser2 The second IniParserA object to merge.
- * @param ... Additional IniParserA objects to merge.
+ * @param parsers The range of IniParserA objects to merge.
+ * @param policy The policy applied to keys defined by more than one parser.
  * @return The merged IniParserA object.
+ * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
  */
-IniParserA MergeIniParsersA(IniParserA parser1, IniParserA parser2, ...);
+template <typename Range>
+IniParserA MergeIniParserRangeA(Range&& parsers, IniMergePolicy policy = IniMergeLastWins) {
+    IniParserA mergedParser;
+    for (auto& parser : parsers) {
+        if constexpr (std::is_lvalue_reference_v<Range>) {
+            mergedParser.merge(parser, policy);
+        }
+        else {
+            mergedParser.merge(std::move(parser), policy);
+        }
+    }
+    return mergedParser;
+}
 
 /**
  * @brief Merge multiple IniParserW objects into one.
  *
- * This function merges multiple IniParserW objects into one.
+ * This function merges any number of IniParserW objects, in order, into a new parser. Parsers passed
+ * as lvalues are copied from; parsers passed as rvalues (std::move) are spliced without copying their
+ * sections and values. The first parser is moved or copied into the result as a whole.
+ *
+ * @param policy The policy applied to keys defined by more than one parser.
+ * @param first The first IniParserW object to merge.
+ * @param rest Additional IniParserW objects to merge.
+ * @return The merged IniParserW object.
+ * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
+ */
+template <typename First, typename... Rest>
+IniParserW MergeIniParsersW(IniMergePolicy policy, First&& first, Rest&&... rest) {
+    static_assert(std::is_same_v<std::decay_t<First>, IniParserW> && (std::is_same_v<std::decay_t<Rest>, IniParserW> && ...),
+        "MergeIniParsersW only accepts IniParserW objects");
+
+    IniParserW mergedParser(std::forward<First>(first));
+    (mergedParser.merge(std::forward<Rest>(rest), policy), ...);
+    return mergedParser;
+}
+
+/**
+ * @brief Merge multiple IniParserW objects into one, the last value of a key winning.
+ *
+ * @param first The first IniParserW object to merge.
+ * @param rest Additional IniParserW objects to merge.
+ * @return The merged IniParserW object.
+ */
+template <typename First, typename... Rest, typename = std::enable_if_t<std::is_same_v<std::decay_t<First>, IniParserW>>>
+IniParserW MergeIniParsersW(First&& first, Rest&&... rest) {
+    return MergeIniParsersW(IniMergeLastWins, std::forward<First>(first), std::forward<Rest>(rest)...);
+}
+
+/**
+ * @brief Merge a range of IniParserW objects into one.
+ *
+ * This function merges the parsers of a range (for example a std::vector<IniParserW>), in order,
+ * into a new parser. If the range itself is passed as an rvalue, its parsers are spliced instead of copied.
  *
- * @param parser1 The first IniParserW object to merge.
- * @param parser2 The second IniParserW object to merge.
- * @param ... Additional IniParserW objects to merge.
+ * @param parsers The range of IniParserW objects to merge.
+ * @param policy The policy applied to keys defined by more than one parser.
  * @return The merged IniParserW object.
+ * @throws std::runtime_error If the policy is IniMergeError and a key has two different values.
  */
-IniParserW MergeIniParsersW(IniParserW parser1, IniParserW parser2, ...);
\ No newline at end of file
+template <typename Range>
+IniParserW MergeIniParserRangeW(Range&& parsers, IniMergePolicy policy = IniMergeLastWins) {
+    IniParserW mergedParser;
+    for (auto& parser : parsers) {
+        if constexpr (std::is_lvalue_reference_v<Range>) {
+            mergedParser.merge(parser, policy);
+        }
+        else {
+            mergedParser.merge(std::move(parser), policy);
+        }
+    }
+    return mergedParser;
+}
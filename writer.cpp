@@ -0,0 +1,186 @@
+#include "writer.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+IniOutputFile::IniOutputFile()
+    : file(INVALID_HANDLE_VALUE), mapping(nullptr), mapped(nullptr), length(0)
+{
+}
+
+#else
+
+IniOutputFile::IniOutputFile()
+    : file(-1), mapped(nullptr), length(0)
+{
+}
+
+#endif
+
+IniOutputFile::~IniOutputFile()
+{
+    this->close();
+}
+
+bool IniOutputFile::open(const std::filesystem::path& path, std::size_t size)
+{
+    this->close();
+
+#if defined(_WIN32)
+    this->file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    this->length = size;
+    if (size == 0)
+    {
+        return true;
+    }
+
+    // Setting the end of the file allocates its clusters, so a full disk fails here.
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(this->file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(this->file))
+    {
+        this->close();
+        return false;
+    }
+
+    unsigned long long mappingSize = size;
+    this->mapping = CreateFileMappingW(this->file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize & 0xFFFFFFFFull), nullptr);
+    if (this->mapping)
+    {
+        this->mapped = static_cast<char*>(MapViewOfFile(this->mapping, FILE_MAP_WRITE, 0, 0, size));
+    }
+    return true;
+#else
+    this->file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (this->file < 0)
+    {
+        return false;
+    }
+
+    this->length = size;
+    if (size == 0)
+    {
+        return true;
+    }
+
+    if (::ftruncate(this->file, static_cast<off_t>(size)) != 0)
+    {
+        this->close();
+        return false;
+    }
+
+#if defined(__linux__)
+    // Reserve the blocks now, so a full disk fails here rather than as a SIGBUS while the mapping is written.
+    int reserved = posix_fallocate(this->file, 0, static_cast<off_t>(size));
+    if (reserved != 0 && reserved != EINVAL && reserved != EOPNOTSUPP)
+    {
+        this->close();
+        return false;
+    }
+#endif
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->file, 0);
+    this->mapped = view == MAP_FAILED ? nullptr : static_cast<char*>(view);
+    return true;
+#endif
+}
+
+bool IniOutputFile::write(std::size_t offset, const char* data, std::size_t size)
+{
+#if defined(_WIN32)
+    while (size != 0)
+    {
+        DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+        OVERLAPPED position = {};
+        position.Offset = static_cast<DWORD>(static_cast<unsigned long long>(offset) & 0xFFFFFFFFull);
+        position.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(offset) >> 32);
+
+        DWORD written = 0;
+        if (!WriteFile(this->file, data, chunk, &written, &position) || written == 0)
+        {
+            return false;
+        }
+        offset += written;
+        data += written;
+        size -= written;
+    }
+    return true;
+#else
+    while (size != 0)
+    {
+        ssize_t written = ::pwrite(this->file, data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+        offset += static_cast<std::size_t>(written);
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+#endif
+}
+
+bool IniOutputFile::close()
+{
+#if defined(_WIN32)
+    if (this->file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    bool closed = true;
+    if (this->mapped)
+    {
+        closed = UnmapViewOfFile(this->mapped) != 0;
+    }
+    if (this->mapping)
+    {
+        CloseHandle(this->mapping);
+    }
+    closed = CloseHandle(this->file) != 0 && closed;
+
+    this->file = INVALID_HANDLE_VALUE;
+    this->mapping = nullptr;
+#else
+    if (this->file < 0)
+    {
+        return false;
+    }
+
+    bool closed = true;
+    if (this->mapped)
+    {
+        closed = munmap(this->mapped, this->length) == 0;
+    }
+    closed = ::close(this->file) == 0 && closed;
+
+    this->file = -1;
+#endif
+
+    this->mapped = nullptr;
+    this->length = 0;
+    return closed;
+}
@@ -0,0 +1,496 @@
+#pragma once
+
+#pragma region              includes
+
+#include                    <algorithm>
+#include                    <atomic>
+#include                    <cstddef>
+#include                    <cstring>
+#include                    <filesystem>
+#include                    <iterator>
+#include                    <map>
+#include                    <string>
+#include                    <string_view>
+#include                    <type_traits>
+#include                    <utility>
+#include                    <vector>
+
+#include                    "async.hpp"
+#include                    "parser.hpp"
+
+#pragma endregion
+
+#pragma region              helpers
+
+/**
+ * @brief Order of the sections and keys written by IniParallelWriter.
+ */
+enum IniWriteOrder {
+    IniWriteSorted = 0,     ///< Sections and keys in ascending order, like IniParser::commit().
+    IniWriteInsertion       ///< Sections in the order they were first added, keys in the order they were added.
+};
+
+/**
+ * @brief Get the number of bytes a text takes in an output file.
+ */
+inline std::size_t IniOutputLength(std::string_view text) {
+    return text.size();
+}
+
+/**
+ * @brief Get the number of bytes a wide text takes in an output file, encoded in UTF-8.
+ *
+ * Unpaired surrogates and values that are not code points take the 3 bytes of U+FFFD.
+ */
+inline std::size_t IniOutputLength(std::wstring_view text) {
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        unsigned long c = static_cast<unsigned long>(text[i]);
+        if (c < 0x80) {
+            length += 1;
+        }
+        else if (c < 0x800) {
+            length += 2;
+        }
+        else if (sizeof(wchar_t) == 2 && c >= 0xD800 && c < 0xDC00 && i + 1 < text.size()
+            && static_cast<unsigned long>(text[i + 1]) - 0xDC00 < 0x400) {
+            length += 4;
+            ++i;
+        }
+        else if (c < 0x10000 || c > 0x10FFFF) {
+            length += 3;
+        }
+        else {
+            length += 4;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief Copy a text into an output buffer.
+ *
+ * @return The end of the copied text.
+ */
+inline char* IniOutputWrite(char* out, std::string_view text) {
+    if (!text.empty()) {
+        std::memcpy(out, text.data(), text.size());
+    }
+    return out + text.size();
+}
+
+/**
+ * @brief Encode a wide text in UTF-8 into an output buffer, see IniOutputLength().
+ *
+ * @return The end of the encoded text.
+ */
+inline char* IniOutputWrite(char* out, std::wstring_view text) {
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        unsigned long c = static_cast<unsigned long>(text[i]);
+        if (sizeof(wchar_t) == 2 && c >= 0xD800 && c < 0xDC00 && i + 1 < text.size()
+            && static_cast<unsigned long>(text[i + 1]) - 0xDC00 < 0x400) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<unsigned long>(text[++i]) - 0xDC00);
+        }
+        else if ((c >= 0xD800 && c < 0xE000) || c > 0x10FFFF) {
+            c = 0xFFFD;
+        }
+
+        if (c < 0x80) {
+            *out++ = static_cast<char>(c);
+        }
+        else if (c < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (c >> 6));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (c >> 12));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else {
+            *out++ = static_cast<char>(0xF0 | (c >> 18));
+            *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Output file of a known size, written at known offsets by several threads.
+ *
+ * open() creates or truncates the file, gives it its final size, reserves its disk space where the
+ * system supports it, and maps it for writing. If the file cannot be mapped, data() returns nullptr
+ * and the content is written with write() at its offsets instead.
+ */
+class IniOutputFile {
+public:
+    IniOutputFile();
+
+    ~IniOutputFile();
+
+    IniOutputFile(const IniOutputFile&) = delete;
+    IniOutputFile& operator=(const IniOutputFile&) = delete;
+
+    /**
+     * @brief Create a file of the given size.
+     *
+     * @param path The name of the file.
+     * @param size The size of the file, in bytes.
+     * @return True if the file was created with its size, false otherwise.
+     */
+    bool open(const std::filesystem::path& path, std::size_t size);
+
+    /**
+     * @brief Get the mapped content of the file.
+     *
+     * @return The first byte of the file, or nullptr if the file is empty or could not be mapped.
+     */
+    char* data() const {
+        return this->mapped;
+    }
+
+    /**
+     * @brief Write bytes at an offset of the file, without going through the mapping.
+     *
+     * @param offset The offset of the first byte.
+     * @param data The bytes to write.
+     * @param size The number of bytes.
+     * @return True if every byte was written, false otherwise.
+     */
+    bool write(std::size_t offset, const char* data, std::size_t size);
+
+    /**
+     * @brief Unmap and close the file.
+     *
+     * @return True if the file was open and was closed without error, false otherwise.
+     */
+    bool close();
+
+private:
+#if defined(_WIN32)
+    void* file;
+    void* mapping;
+#else
+    int file;
+#endif
+    char* mapped;
+    std::size_t length;
+};
+
+#pragma endregion
+
+/**
+ * @brief Write large INI documents with several threads.
+ *
+ * The document is cut into blocks of about BlockPairs key-value pairs. The size of every block is
+ * computed in parallel, the offsets of the blocks follow from their sizes, the output file is created
+ * with its final size and mapped, and the blocks are formatted in parallel straight into their place
+ * in the file. The calling thread takes part, and the pool threads help it, see IniLoadPool::parallel_for().
+ * Only the walk that cuts the blocks is serial.
+ *
+ * The lines are the ones IniParser::commit() writes, "[section]" and "key=value", ending with '\n' on
+ * every system. Wide documents are written in UTF-8.
+ *
+ * commit(const Parser&, ...) writes a parser in the order of IniParser::commit(). To write a generated
+ * document in the order it was produced, add() its pairs to a writer and commit() it with IniWriteInsertion:
+ *
+ *     IniParallelWriterA writer;
+ *     writer.add("server", "host", "example.org");
+ *     writer.add("server", "port", "8080");
+ *     writer.commit("generated.ini", IniWriteInsertion);
+ */
+template <typename Parser>
+class IniBasicParallelWriter {
+public:
+    typedef typename Parser::char_type              char_type;
+    typedef typename Parser::string_type            string_type;
+    typedef std::basic_string_view<char_type>       view_type;
+
+    /**
+     * @brief Number of key-value pairs formatted by one thread at a time.
+     */
+    static constexpr std::size_t BlockPairs = 1024;
+
+    /**
+     * @brief Write the content of a parser to a file.
+     *
+     * The file has the content IniParser::commit() writes, in the same order, including every value of
+     * the keys read with IniDuplicateKeepAll.
+     *
+     * @param ini The parser to write. It must not be modified during the call.
+     * @param filename The name of the file to write to.
+     * @param pool The pool whose threads help the calling thread.
+     * @return True if the file was successfully written, false otherwise.
+     */
+    static bool commit(const Parser& ini, const std::filesystem::path& filename, IniLoadPool& pool = IniLoadPool::shared()) {
+        XINI_STATS(IniStatsScope timer(ini.counters.commitDuration));
+
+        std::vector<ParserBlock> blocks;
+        for (const auto& section : ini.data) {
+            const repeated_section* repeated = nullptr;
+            if (!ini.repeated.empty()) {
+                auto repeatedIt = ini.repeated.find(section.first);
+                if (repeatedIt != ini.repeated.end()) {
+                    repeated = &repeatedIt->second;
+                }
+            }
+
+            auto first = section.second.begin();
+            std::size_t remaining = section.second.size();
+            const string_type* header = &section.first;
+            do {
+                std::size_t count = std::min(remaining, BlockPairs);
+                blocks.push_back({ header, repeated, first, count });
+                std::advance(first, count);
+                remaining -= count;
+                header = nullptr;
+            } while (remaining != 0);
+        }
+
+        return write_blocks(filename, blocks, pool);
+    }
+
+    /**
+     * @brief Add a section, written even if no key-value pair is added to it.
+     *
+     * @param name The name of the section.
+     */
+    void section(view_type name) {
+        this->section_at(name);
+    }
+
+    /**
+     * @brief Add a key-value pair.
+     *
+     * The pair is appended to its section. A key added several times is written on as many lines.
+     *
+     * @param section The section of the key-value pair.
+     * @param key The key of the key-value pair.
+     * @param value The value of the key-value pair.
+     */
+    void add(view_type section, string_type key, string_type value) {
+        this->section_at(section).pairs.emplace_back(std::move(key), std::move(value));
+        ++this->pairs;
+    }
+
+    /**
+     * @brief Get the number of key-value pairs added.
+     *
+     * @return The number of key-value pairs.
+     */
+    std::size_t size() const {
+        return this->pairs;
+    }
+
+    /**
+     * @brief Remove every section and key-value pair.
+     */
+    void clear() {
+        this->sections.clear();
+        this->positions.clear();
+        this->pairs = 0;
+    }
+
+    /**
+     * @brief Write the sections and key-value pairs added to a file.
+     *
+     * @param filename The name of the file to write to.
+     * @param order The order of the sections and keys. Sorted output keeps the repeated keys in the order they were added.
+     * @param pool The pool whose threads help the calling thread.
+     * @return True if the file was successfully written, false otherwise.
+     */
+    bool commit(const std::filesystem::path& filename, IniWriteOrder order = IniWriteInsertion, IniLoadPool& pool = IniLoadPool::shared()) const {
+        std::vector<const Section*> sectionOrder;
+        sectionOrder.reserve(this->sections.size());
+        for (const auto& section : this->sections) {
+            sectionOrder.push_back(&section);
+        }
+
+        // Sorted output goes through an index of the pairs of each section, sorted in parallel.
+        std::vector<std::vector<const pair_type*>> sorted;
+        if (order == IniWriteSorted) {
+            std::sort(sectionOrder.begin(), sectionOrder.end(), [](const Section* left, const Section* right) {
+                return left->name < right->name;
+            });
+
+            sorted.resize(this->sections.size());
+            pool.parallel_for(this->sections.size(), [&](std::size_t i) {
+                std::vector<const pair_type*>& index = sorted[i];
+                index.reserve(this->sections[i].pairs.size());
+                for (const auto& pair : this->sections[i].pairs) {
+                    index.push_back(&pair);
+                }
+                std::stable_sort(index.begin(), index.end(), [](const pair_type* left, const pair_type* right) {
+                    return left->first < right->first;
+                });
+            });
+        }
+
+        std::vector<WriterBlock> blocks;
+        for (const Section* section : sectionOrder) {
+            const pair_type* const* index = sorted.empty() ? nullptr : sorted[section - this->sections.data()].data();
+            const string_type* header = &section->name;
+            std::size_t first = 0;
+            do {
+                std::size_t count = std::min(section->pairs.size() - first, BlockPairs);
+                blocks.push_back({ header, section->pairs.data() + first, index ? index + first : nullptr, count });
+                first += count;
+                header = nullptr;
+            } while (first != section->pairs.size());
+        }
+
+        return write_blocks(filename, blocks, pool);
+    }
+
+private:
+    typedef std::pair<string_type, string_type>     pair_type;
+
+    typedef typename std::remove_reference_t<decltype(std::declval<const Parser&>().repeated)>::mapped_type repeated_section;
+
+    struct Section {
+        string_type name;
+        std::vector<pair_type> pairs;
+    };
+
+    /**
+     * @brief Pairs of a parser section formatted by one thread.
+     */
+    struct ParserBlock {
+        const string_type* header;                  ///< The section, if the block starts it, or nullptr.
+        const repeated_section* repeated;           ///< The repeated values of the section, if any.
+        typename Parser::section_type::const_iterator first;
+        std::size_t count;
+
+        template <typename Visit>
+        void each(Visit visit) const {
+            auto pair = this->first;
+            for (std::size_t i = 0; i < this->count; ++i, ++pair) {
+                if (this->repeated) {
+                    auto valuesIt = this->repeated->find(pair->first);
+                    if (valuesIt != this->repeated->end()) {
+                        for (const auto& value : valuesIt->second) {
+                            visit(pair->first, value);
+                        }
+                        continue;
+                    }
+                }
+                visit(pair->first, pair->second);
+            }
+        }
+    };
+
+    /**
+     * @brief Pairs added to a writer formatted by one thread.
+     */
+    struct WriterBlock {
+        const string_type* header;                  ///< The section, if the block starts it, or nullptr.
+        const pair_type* pairs;                     ///< The pairs, in the order they were added.
+        const pair_type* const* sorted;             ///< The pairs in sorted order, or nullptr for insertion order.
+        std::size_t count;
+
+        template <typename Visit>
+        void each(Visit visit) const {
+            for (std::size_t i = 0; i < this->count; ++i) {
+                const pair_type& pair = this->sorted ? *this->sorted[i] : this->pairs[i];
+                visit(pair.first, pair.second);
+            }
+        }
+    };
+
+    /**
+     * @brief Size the blocks, create the file and format every block at its offset.
+     */
+    template <typename Block>
+    static bool write_blocks(const std::filesystem::path& filename, const std::vector<Block>& blocks, IniLoadPool& pool) {
+        std::vector<std::size_t> offsets(blocks.size() + 1, 0);
+        pool.parallel_for(blocks.size(), [&](std::size_t i) {
+            std::size_t size = blocks[i].header ? IniOutputLength(view_type(*blocks[i].header)) + 3 : 0;
+            blocks[i].each([&size](const string_type& key, const string_type& value) {
+                size += IniOutputLength(view_type(key)) + IniOutputLength(view_type(value)) + 2;
+            });
+            offsets[i + 1] = size;
+        });
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        IniOutputFile file;
+        if (!file.open(filename, offsets.back())) {
+            return false;
+        }
+
+        std::atomic<bool> written(true);
+        pool.parallel_for(blocks.size(), [&](std::size_t i) {
+            char* mapped = file.data();
+            if (mapped) {
+                format(blocks[i], mapped + offsets[i]);
+                return;
+            }
+
+            std::string buffer(offsets[i + 1] - offsets[i], '\0');
+            format(blocks[i], &buffer[0]);
+            if (!file.write(offsets[i], buffer.data(), buffer.size())) {
+                written = false;
+            }
+        });
+
+        return file.close() && written;
+    }
+
+    template <typename Block>
+    static void format(const Block& block, char* out) {
+        if (block.header) {
+            *out++ = '[';
+            out = IniOutputWrite(out, view_type(*block.header));
+            *out++ = ']';
+            *out++ = '\n';
+        }
+        block.each([&out](const string_type& key, const string_type& value) {
+            out = IniOutputWrite(out, view_type(key));
+            *out++ = '=';
+            out = IniOutputWrite(out, view_type(value));
+            *out++ = '\n';
+        });
+    }
+
+    Section& section_at(view_type name) {
+        auto positionIt = this->positions.find(name);
+        if (positionIt == this->positions.end()) {
+            positionIt = this->positions.emplace(string_type(name), this->sections.size()).first;
+            this->sections.push_back({ string_type(name), {} });
+        }
+        return this->sections[positionIt->second];
+    }
+
+    std::vector<Section> sections;
+    std::map<string_type, std::size_t, std::less<>> positions;
+    std::size_t pairs = 0;
+};
+
+/**
+ * @brief Parallel writer of IniParserA documents.
+ */
+typedef IniBasicParallelWriter<IniParserA>  IniParallelWriterA;
+
+/**
+ * @brief Parallel writer of IniParserW documents.
+ */
+typedef IniBasicParallelWriter<IniParserW>  IniParallelWriterW;
+
+#if defined(_UNICODE)
+
+/**
+ * @brief Macro that defines the parallel writer type based on whether the _UNICODE macro is defined.
+ */
+# define IniParallelWriter      IniParallelWriterW
+
+#else
+
+/**
+ * @brief Macro that defines the parallel writer type based on whether the _UNICODE macro is defined.
+ */
+# define IniParallelWriter      IniParallelWriterA
+
+#endif